@@ -397,12 +397,15 @@ D3DXMATRIX* WINAPI D3DXMatrixMultiply(D3DXMATRIX *pout, const D3DXMATRIX *pm1, c
 
     TRACE("pout %p, pm1 %p, pm2 %p\n", pout, pm1, pm2);
 
+    /* Compute each output row as a linear combination of the rows of pm2,
+     * which the compiler can turn into vector operations. The order of the
+     * operations for each element is the same as for a dot product. */
     for (i=0; i<4; i++)
     {
+        const FLOAT a0 = pm1->u.m[i][0], a1 = pm1->u.m[i][1], a2 = pm1->u.m[i][2], a3 = pm1->u.m[i][3];
+
         for (j=0; j<4; j++)
-        {
-            out.u.m[i][j] = pm1->u.m[i][0] * pm2->u.m[0][j] + pm1->u.m[i][1] * pm2->u.m[1][j] + pm1->u.m[i][2] * pm2->u.m[2][j] + pm1->u.m[i][3] * pm2->u.m[3][j];
-        }
+            out.u.m[i][j] = a0 * pm2->u.m[0][j] + a1 * pm2->u.m[1][j] + a2 * pm2->u.m[2][j] + a3 * pm2->u.m[3][j];
     }
 
     *pout = out;
@@ -417,8 +420,12 @@ D3DXMATRIX* WINAPI D3DXMatrixMultiplyTranspose(D3DXMATRIX *pout, const D3DXMATRI
     TRACE("pout %p, pm1 %p, pm2 %p\n", pout, pm1, pm2);
 
     for (i = 0; i < 4; i++)
+    {
+        const FLOAT a0 = pm1->u.m[i][0], a1 = pm1->u.m[i][1], a2 = pm1->u.m[i][2], a3 = pm1->u.m[i][3];
+
         for (j = 0; j < 4; j++)
-            temp.u.m[j][i] = pm1->u.m[i][0] * pm2->u.m[0][j] + pm1->u.m[i][1] * pm2->u.m[1][j] + pm1->u.m[i][2] * pm2->u.m[2][j] + pm1->u.m[i][3] * pm2->u.m[3][j];
+            temp.u.m[j][i] = a0 * pm2->u.m[0][j] + a1 * pm2->u.m[1][j] + a2 * pm2->u.m[2][j] + a3 * pm2->u.m[3][j];
+    }
 
     *pout = temp;
     return pout;
@@ -1271,30 +1278,39 @@ D3DXPLANE * WINAPI D3DXPlaneNormalize(D3DXPLANE *out, const D3DXPLANE *p)
     return out;
 }
 
-D3DXPLANE* WINAPI D3DXPlaneTransform(D3DXPLANE *pout, const D3DXPLANE *pplane, const D3DXMATRIX *pm)
+static inline void plane_transform(D3DXPLANE *out, const D3DXPLANE *in, const D3DXMATRIX *m)
 {
-    const D3DXPLANE plane = *pplane;
+    const D3DXPLANE plane = *in;
+    D3DXPLANE r;
+
+    r.a = m->u.m[0][0] * plane.a + m->u.m[1][0] * plane.b + m->u.m[2][0] * plane.c + m->u.m[3][0] * plane.d;
+    r.b = m->u.m[0][1] * plane.a + m->u.m[1][1] * plane.b + m->u.m[2][1] * plane.c + m->u.m[3][1] * plane.d;
+    r.c = m->u.m[0][2] * plane.a + m->u.m[1][2] * plane.b + m->u.m[2][2] * plane.c + m->u.m[3][2] * plane.d;
+    r.d = m->u.m[0][3] * plane.a + m->u.m[1][3] * plane.b + m->u.m[2][3] * plane.c + m->u.m[3][3] * plane.d;
 
+    *out = r;
+}
+
+D3DXPLANE* WINAPI D3DXPlaneTransform(D3DXPLANE *pout, const D3DXPLANE *pplane, const D3DXMATRIX *pm)
+{
     TRACE("pout %p, pplane %p, pm %p\n", pout, pplane, pm);
 
-    pout->a = pm->u.m[0][0] * plane.a + pm->u.m[1][0] * plane.b + pm->u.m[2][0] * plane.c + pm->u.m[3][0] * plane.d;
-    pout->b = pm->u.m[0][1] * plane.a + pm->u.m[1][1] * plane.b + pm->u.m[2][1] * plane.c + pm->u.m[3][1] * plane.d;
-    pout->c = pm->u.m[0][2] * plane.a + pm->u.m[1][2] * plane.b + pm->u.m[2][2] * plane.c + pm->u.m[3][2] * plane.d;
-    pout->d = pm->u.m[0][3] * plane.a + pm->u.m[1][3] * plane.b + pm->u.m[2][3] * plane.c + pm->u.m[3][3] * plane.d;
+    plane_transform(pout, pplane, pm);
     return pout;
 }
 
 D3DXPLANE* WINAPI D3DXPlaneTransformArray(D3DXPLANE* out, UINT outstride, const D3DXPLANE* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
     for (i = 0; i < elements; ++i) {
-        D3DXPlaneTransform(
+        plane_transform(
             (D3DXPLANE*)((char*)out + outstride * i),
             (const D3DXPLANE*)((const char*)in + instride * i),
-            matrix);
+            &m);
     }
     return out;
 }
@@ -1673,88 +1689,112 @@ D3DXVECTOR2* WINAPI D3DXVec2Normalize(D3DXVECTOR2 *pout, const D3DXVECTOR2 *pv)
     return pout;
 }
 
-D3DXVECTOR4* WINAPI D3DXVec2Transform(D3DXVECTOR4 *pout, const D3DXVECTOR2 *pv, const D3DXMATRIX *pm)
+static inline void vec2_transform(D3DXVECTOR4 *out, const D3DXVECTOR2 *in, const D3DXMATRIX *m)
 {
-    D3DXVECTOR4 out;
+    const D3DXVECTOR2 v = *in;
+    D3DXVECTOR4 r;
+
+    r.x = m->u.m[0][0] * v.x + m->u.m[1][0] * v.y  + m->u.m[3][0];
+    r.y = m->u.m[0][1] * v.x + m->u.m[1][1] * v.y  + m->u.m[3][1];
+    r.z = m->u.m[0][2] * v.x + m->u.m[1][2] * v.y  + m->u.m[3][2];
+    r.w = m->u.m[0][3] * v.x + m->u.m[1][3] * v.y  + m->u.m[3][3];
+
+    *out = r;
+}
 
+D3DXVECTOR4* WINAPI D3DXVec2Transform(D3DXVECTOR4 *pout, const D3DXVECTOR2 *pv, const D3DXMATRIX *pm)
+{
     TRACE("pout %p, pv %p, pm %p\n", pout, pv, pm);
 
-    out.x = pm->u.m[0][0] * pv->x + pm->u.m[1][0] * pv->y  + pm->u.m[3][0];
-    out.y = pm->u.m[0][1] * pv->x + pm->u.m[1][1] * pv->y  + pm->u.m[3][1];
-    out.z = pm->u.m[0][2] * pv->x + pm->u.m[1][2] * pv->y  + pm->u.m[3][2];
-    out.w = pm->u.m[0][3] * pv->x + pm->u.m[1][3] * pv->y  + pm->u.m[3][3];
-    *pout = out;
+    vec2_transform(pout, pv, pm);
     return pout;
 }
 
 D3DXVECTOR4* WINAPI D3DXVec2TransformArray(D3DXVECTOR4* out, UINT outstride, const D3DXVECTOR2* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
     for (i = 0; i < elements; ++i) {
-        D3DXVec2Transform(
+        vec2_transform(
             (D3DXVECTOR4*)((char*)out + outstride * i),
             (const D3DXVECTOR2*)((const char*)in + instride * i),
-            matrix);
+            &m);
     }
     return out;
 }
 
-D3DXVECTOR2* WINAPI D3DXVec2TransformCoord(D3DXVECTOR2 *pout, const D3DXVECTOR2 *pv, const D3DXMATRIX *pm)
+static inline void vec2_transform_coord(D3DXVECTOR2 *out, const D3DXVECTOR2 *in, const D3DXMATRIX *m)
 {
-    D3DXVECTOR2 v;
+    const D3DXVECTOR2 v = *in;
+    D3DXVECTOR2 r;
     FLOAT norm;
 
-    TRACE("pout %p, pv %p, pm %p\n", pout, pv, pm);
+    norm = m->u.m[0][3] * v.x + m->u.m[1][3] * v.y + m->u.m[3][3];
 
-    v = *pv;
-    norm = pm->u.m[0][3] * pv->x + pm->u.m[1][3] * pv->y + pm->u.m[3][3];
+    r.x = (m->u.m[0][0] * v.x + m->u.m[1][0] * v.y + m->u.m[3][0]) / norm;
+    r.y = (m->u.m[0][1] * v.x + m->u.m[1][1] * v.y + m->u.m[3][1]) / norm;
+
+    *out = r;
+}
 
-    pout->x = (pm->u.m[0][0] * v.x + pm->u.m[1][0] * v.y + pm->u.m[3][0]) / norm;
-    pout->y = (pm->u.m[0][1] * v.x + pm->u.m[1][1] * v.y + pm->u.m[3][1]) / norm;
+D3DXVECTOR2* WINAPI D3DXVec2TransformCoord(D3DXVECTOR2 *pout, const D3DXVECTOR2 *pv, const D3DXMATRIX *pm)
+{
+    TRACE("pout %p, pv %p, pm %p\n", pout, pv, pm);
 
+    vec2_transform_coord(pout, pv, pm);
     return pout;
 }
 
 D3DXVECTOR2* WINAPI D3DXVec2TransformCoordArray(D3DXVECTOR2* out, UINT outstride, const D3DXVECTOR2* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
     for (i = 0; i < elements; ++i) {
-        D3DXVec2TransformCoord(
+        vec2_transform_coord(
             (D3DXVECTOR2*)((char*)out + outstride * i),
             (const D3DXVECTOR2*)((const char*)in + instride * i),
-            matrix);
+            &m);
     }
     return out;
 }
 
-D3DXVECTOR2* WINAPI D3DXVec2TransformNormal(D3DXVECTOR2 *pout, const D3DXVECTOR2 *pv, const D3DXMATRIX *pm)
+static inline void vec2_transform_normal(D3DXVECTOR2 *out, const D3DXVECTOR2 *in, const D3DXMATRIX *m)
 {
-    const D3DXVECTOR2 v = *pv;
+    const D3DXVECTOR2 v = *in;
+    D3DXVECTOR2 r;
 
+    r.x = m->u.m[0][0] * v.x + m->u.m[1][0] * v.y;
+    r.y = m->u.m[0][1] * v.x + m->u.m[1][1] * v.y;
+
+    *out = r;
+}
+
+D3DXVECTOR2* WINAPI D3DXVec2TransformNormal(D3DXVECTOR2 *pout, const D3DXVECTOR2 *pv, const D3DXMATRIX *pm)
+{
     TRACE("pout %p, pv %p, pm %p\n", pout, pv, pm);
 
-    pout->x = pm->u.m[0][0] * v.x + pm->u.m[1][0] * v.y;
-    pout->y = pm->u.m[0][1] * v.x + pm->u.m[1][1] * v.y;
+    vec2_transform_normal(pout, pv, pm);
     return pout;
 }
 
-D3DXVECTOR2* WINAPI D3DXVec2TransformNormalArray(D3DXVECTOR2* out, UINT outstride, const D3DXVECTOR2 *in, UINT instride, const D3DXMATRIX *matrix, UINT elements)
+D3DXVECTOR2* WINAPI D3DXVec2TransformNormalArray(D3DXVECTOR2* out, UINT outstride, const D3DXVECTOR2* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
     for (i = 0; i < elements; ++i) {
-        D3DXVec2TransformNormal(
+        vec2_transform_normal(
             (D3DXVECTOR2*)((char*)out + outstride * i),
             (const D3DXVECTOR2*)((const char*)in + instride * i),
-            matrix);
+            &m);
     }
     return out;
 }
@@ -1859,92 +1899,114 @@ D3DXVECTOR3* WINAPI D3DXVec3ProjectArray(D3DXVECTOR3* out, UINT outstride, const
     return out;
 }
 
-D3DXVECTOR4* WINAPI D3DXVec3Transform(D3DXVECTOR4 *pout, const D3DXVECTOR3 *pv, const D3DXMATRIX *pm)
+static inline void vec3_transform(D3DXVECTOR4 *out, const D3DXVECTOR3 *in, const D3DXMATRIX *m)
 {
-    D3DXVECTOR4 out;
+    const D3DXVECTOR3 v = *in;
+    D3DXVECTOR4 r;
+
+    r.x = m->u.m[0][0] * v.x + m->u.m[1][0] * v.y + m->u.m[2][0] * v.z + m->u.m[3][0];
+    r.y = m->u.m[0][1] * v.x + m->u.m[1][1] * v.y + m->u.m[2][1] * v.z + m->u.m[3][1];
+    r.z = m->u.m[0][2] * v.x + m->u.m[1][2] * v.y + m->u.m[2][2] * v.z + m->u.m[3][2];
+    r.w = m->u.m[0][3] * v.x + m->u.m[1][3] * v.y + m->u.m[2][3] * v.z + m->u.m[3][3];
 
+    *out = r;
+}
+
+D3DXVECTOR4* WINAPI D3DXVec3Transform(D3DXVECTOR4 *pout, const D3DXVECTOR3 *pv, const D3DXMATRIX *pm)
+{
     TRACE("pout %p, pv %p, pm %p\n", pout, pv, pm);
 
-    out.x = pm->u.m[0][0] * pv->x + pm->u.m[1][0] * pv->y + pm->u.m[2][0] * pv->z + pm->u.m[3][0];
-    out.y = pm->u.m[0][1] * pv->x + pm->u.m[1][1] * pv->y + pm->u.m[2][1] * pv->z + pm->u.m[3][1];
-    out.z = pm->u.m[0][2] * pv->x + pm->u.m[1][2] * pv->y + pm->u.m[2][2] * pv->z + pm->u.m[3][2];
-    out.w = pm->u.m[0][3] * pv->x + pm->u.m[1][3] * pv->y + pm->u.m[2][3] * pv->z + pm->u.m[3][3];
-    *pout = out;
+    vec3_transform(pout, pv, pm);
     return pout;
 }
 
 D3DXVECTOR4* WINAPI D3DXVec3TransformArray(D3DXVECTOR4* out, UINT outstride, const D3DXVECTOR3* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
     for (i = 0; i < elements; ++i) {
-        D3DXVec3Transform(
+        vec3_transform(
             (D3DXVECTOR4*)((char*)out + outstride * i),
             (const D3DXVECTOR3*)((const char*)in + instride * i),
-            matrix);
+            &m);
     }
     return out;
 }
 
-D3DXVECTOR3* WINAPI D3DXVec3TransformCoord(D3DXVECTOR3 *pout, const D3DXVECTOR3 *pv, const D3DXMATRIX *pm)
+static inline void vec3_transform_coord(D3DXVECTOR3 *out, const D3DXVECTOR3 *in, const D3DXMATRIX *m)
 {
-    D3DXVECTOR3 out;
+    const D3DXVECTOR3 v = *in;
+    D3DXVECTOR3 r;
     FLOAT norm;
 
-    TRACE("pout %p, pv %p, pm %p\n", pout, pv, pm);
+    norm = m->u.m[0][3] * v.x + m->u.m[1][3] * v.y + m->u.m[2][3] * v.z + m->u.m[3][3];
 
-    norm = pm->u.m[0][3] * pv->x + pm->u.m[1][3] * pv->y + pm->u.m[2][3] *pv->z + pm->u.m[3][3];
+    r.x = (m->u.m[0][0] * v.x + m->u.m[1][0] * v.y + m->u.m[2][0] * v.z + m->u.m[3][0]) / norm;
+    r.y = (m->u.m[0][1] * v.x + m->u.m[1][1] * v.y + m->u.m[2][1] * v.z + m->u.m[3][1]) / norm;
+    r.z = (m->u.m[0][2] * v.x + m->u.m[1][2] * v.y + m->u.m[2][2] * v.z + m->u.m[3][2]) / norm;
 
-    out.x = (pm->u.m[0][0] * pv->x + pm->u.m[1][0] * pv->y + pm->u.m[2][0] * pv->z + pm->u.m[3][0]) / norm;
-    out.y = (pm->u.m[0][1] * pv->x + pm->u.m[1][1] * pv->y + pm->u.m[2][1] * pv->z + pm->u.m[3][1]) / norm;
-    out.z = (pm->u.m[0][2] * pv->x + pm->u.m[1][2] * pv->y + pm->u.m[2][2] * pv->z + pm->u.m[3][2]) / norm;
+    *out = r;
+}
 
-    *pout = out;
+D3DXVECTOR3* WINAPI D3DXVec3TransformCoord(D3DXVECTOR3 *pout, const D3DXVECTOR3 *pv, const D3DXMATRIX *pm)
+{
+    TRACE("pout %p, pv %p, pm %p\n", pout, pv, pm);
 
+    vec3_transform_coord(pout, pv, pm);
     return pout;
 }
 
 D3DXVECTOR3* WINAPI D3DXVec3TransformCoordArray(D3DXVECTOR3* out, UINT outstride, const D3DXVECTOR3* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
     for (i = 0; i < elements; ++i) {
-        D3DXVec3TransformCoord(
+        vec3_transform_coord(
             (D3DXVECTOR3*)((char*)out + outstride * i),
             (const D3DXVECTOR3*)((const char*)in + instride * i),
-            matrix);
+            &m);
     }
     return out;
 }
 
-D3DXVECTOR3* WINAPI D3DXVec3TransformNormal(D3DXVECTOR3 *pout, const D3DXVECTOR3 *pv, const D3DXMATRIX *pm)
+static inline void vec3_transform_normal(D3DXVECTOR3 *out, const D3DXVECTOR3 *in, const D3DXMATRIX *m)
 {
-    const D3DXVECTOR3 v = *pv;
+    const D3DXVECTOR3 v = *in;
+    D3DXVECTOR3 r;
+
+    r.x = m->u.m[0][0] * v.x + m->u.m[1][0] * v.y + m->u.m[2][0] * v.z;
+    r.y = m->u.m[0][1] * v.x + m->u.m[1][1] * v.y + m->u.m[2][1] * v.z;
+    r.z = m->u.m[0][2] * v.x + m->u.m[1][2] * v.y + m->u.m[2][2] * v.z;
+
+    *out = r;
+}
 
+D3DXVECTOR3* WINAPI D3DXVec3TransformNormal(D3DXVECTOR3 *pout, const D3DXVECTOR3 *pv, const D3DXMATRIX *pm)
+{
     TRACE("pout %p, pv %p, pm %p\n", pout, pv, pm);
 
-    pout->x = pm->u.m[0][0] * v.x + pm->u.m[1][0] * v.y + pm->u.m[2][0] * v.z;
-    pout->y = pm->u.m[0][1] * v.x + pm->u.m[1][1] * v.y + pm->u.m[2][1] * v.z;
-    pout->z = pm->u.m[0][2] * v.x + pm->u.m[1][2] * v.y + pm->u.m[2][2] * v.z;
+    vec3_transform_normal(pout, pv, pm);
     return pout;
-
 }
 
 D3DXVECTOR3* WINAPI D3DXVec3TransformNormalArray(D3DXVECTOR3* out, UINT outstride, const D3DXVECTOR3* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
     for (i = 0; i < elements; ++i) {
-        D3DXVec3TransformNormal(
+        vec3_transform_normal(
             (D3DXVECTOR3*)((char*)out + outstride * i),
             (const D3DXVECTOR3*)((const char*)in + instride * i),
-            matrix);
+            &m);
     }
     return out;
 }
@@ -2066,31 +2128,39 @@ D3DXVECTOR4* WINAPI D3DXVec4Normalize(D3DXVECTOR4 *pout, const D3DXVECTOR4 *pv)
     return pout;
 }
 
-D3DXVECTOR4* WINAPI D3DXVec4Transform(D3DXVECTOR4 *pout, const D3DXVECTOR4 *pv, const D3DXMATRIX *pm)
+static inline void vec4_transform(D3DXVECTOR4 *out, const D3DXVECTOR4 *in, const D3DXMATRIX *m)
 {
-    D3DXVECTOR4 out;
+    const D3DXVECTOR4 v = *in;
+    D3DXVECTOR4 r;
+
+    r.x = m->u.m[0][0] * v.x + m->u.m[1][0] * v.y + m->u.m[2][0] * v.z + m->u.m[3][0] * v.w;
+    r.y = m->u.m[0][1] * v.x + m->u.m[1][1] * v.y + m->u.m[2][1] * v.z + m->u.m[3][1] * v.w;
+    r.z = m->u.m[0][2] * v.x + m->u.m[1][2] * v.y + m->u.m[2][2] * v.z + m->u.m[3][2] * v.w;
+    r.w = m->u.m[0][3] * v.x + m->u.m[1][3] * v.y + m->u.m[2][3] * v.z + m->u.m[3][3] * v.w;
+
+    *out = r;
+}
 
+D3DXVECTOR4* WINAPI D3DXVec4Transform(D3DXVECTOR4 *pout, const D3DXVECTOR4 *pv, const D3DXMATRIX *pm)
+{
     TRACE("pout %p, pv %p, pm %p\n", pout, pv, pm);
 
-    out.x = pm->u.m[0][0] * pv->x + pm->u.m[1][0] * pv->y + pm->u.m[2][0] * pv->z + pm->u.m[3][0] * pv->w;
-    out.y = pm->u.m[0][1] * pv->x + pm->u.m[1][1] * pv->y + pm->u.m[2][1] * pv->z + pm->u.m[3][1] * pv->w;
-    out.z = pm->u.m[0][2] * pv->x + pm->u.m[1][2] * pv->y + pm->u.m[2][2] * pv->z + pm->u.m[3][2] * pv->w;
-    out.w = pm->u.m[0][3] * pv->x + pm->u.m[1][3] * pv->y + pm->u.m[2][3] * pv->z + pm->u.m[3][3] * pv->w;
-    *pout = out;
+    vec4_transform(pout, pv, pm);
     return pout;
 }
 
 D3DXVECTOR4* WINAPI D3DXVec4TransformArray(D3DXVECTOR4* out, UINT outstride, const D3DXVECTOR4* in, UINT instride, const D3DXMATRIX* matrix, UINT elements)
 {
+    const D3DXMATRIX m = *matrix;
     UINT i;
 
     TRACE("out %p, outstride %u, in %p, instride %u, matrix %p, elements %u\n", out, outstride, in, instride, matrix, elements);
 
     for (i = 0; i < elements; ++i) {
-        D3DXVec4Transform(
+        vec4_transform(
             (D3DXVECTOR4*)((char*)out + outstride * i),
             (const D3DXVECTOR4*)((const char*)in + instride * i),
-            matrix);
+            &m);
     }
     return out;
 }
@@ -1836,6 +1836,70 @@ void point_filter_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slic
     }
 }
 
+struct dxtn_compress_band
+{
+    TP_WORK *work;
+    const BYTE *src;
+    unsigned int width, height;
+    GLenum format;
+    BYTE *dst;
+    unsigned int dst_pitch;
+};
+
+static void CALLBACK dxtn_compress_band_cb(TP_CALLBACK_INSTANCE *instance, void *context, TP_WORK *work)
+{
+    const struct dxtn_compress_band *band = context;
+
+    tx_compress_dxtn(4, band->width, band->height, band->src, band->format, band->dst, band->dst_pitch);
+}
+
+/* Blocks are compressed independently of each other, so large surfaces are
+ * split into bands of block rows which are compressed on the thread pool.
+ * The result is the same as compressing the whole surface at once. */
+static void compress_dxtn(unsigned int width, unsigned int height, const BYTE *src, GLenum format,
+        BYTE *dst, unsigned int pitch, unsigned int block_width, unsigned int block_byte_count)
+{
+    static const unsigned int min_band_height = 64;
+    struct dxtn_compress_band *bands;
+    unsigned int band_count, band_height, i, y;
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    band_count = min(info.dwNumberOfProcessors, height / min_band_height);
+
+    if (band_count <= 1 || width * height < 256 * 256 || !(bands = heap_alloc(band_count * sizeof(*bands))))
+    {
+        tx_compress_dxtn(4, width, height, src, format, dst, pitch * block_width / block_byte_count);
+        return;
+    }
+
+    band_height = (height / band_count + 3) & ~3;
+    for (i = 0, y = 0; i < band_count && y < height; ++i, y += band_height)
+    {
+        bands[i].src = src + y * width * sizeof(DWORD);
+        bands[i].width = width;
+        bands[i].height = min(band_height, height - y);
+        bands[i].format = format;
+        bands[i].dst = dst + y / 4 * pitch;
+        bands[i].dst_pitch = pitch * block_width / block_byte_count;
+        if ((bands[i].work = CreateThreadpoolWork(dxtn_compress_band_cb, &bands[i], NULL)))
+            SubmitThreadpoolWork(bands[i].work);
+        else
+            dxtn_compress_band_cb(NULL, &bands[i], NULL);
+    }
+    band_count = i;
+
+    for (i = 0; i < band_count; ++i)
+    {
+        if (!bands[i].work)
+            continue;
+        WaitForThreadpoolWorkCallbacks(bands[i].work, FALSE);
+        CloseThreadpoolWork(bands[i].work);
+    }
+
+    heap_free(bands);
+}
+
 /************************************************************
  * D3DXLoadSurfaceFromMemory
  *
@@ -2106,9 +2170,9 @@ HRESULT WINAPI D3DXLoadSurfaceFromMemory(IDirect3DSurface9 *dst_surface,
                 default:
                     ERR("Unexpected destination compressed format %u.\n", surfdesc.Format);
             }
-            tx_compress_dxtn(4, dst_size_aligned.width, dst_size_aligned.height,
-                    dst_uncompressed, gl_format, lockrect.pBits,
-                    lockrect.Pitch * destformatdesc->block_width / destformatdesc->block_byte_count);
+            compress_dxtn(dst_size_aligned.width, dst_size_aligned.height,
+                    dst_uncompressed, gl_format, lockrect.pBits, lockrect.Pitch,
+                    destformatdesc->block_width, destformatdesc->block_byte_count);
             heap_free(dst_uncompressed);
         }
     }
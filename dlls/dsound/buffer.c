@@ -1138,6 +1138,7 @@ void secondarybuffer_destroy(IDirectSoundBufferImpl *This)
 
     HeapFree(GetProcessHeap(), 0, This->notifies);
     HeapFree(GetProcessHeap(), 0, This->pwfx);
+    HeapFree(GetProcessHeap(), 0, This->fir_bank);
 
     if (This->filters) {
         int i;
@@ -1194,6 +1195,7 @@ HRESULT IDirectSoundBufferImpl_Duplicate(
     dsb->sec_mixpos = 0;
     dsb->notifies = NULL;
     dsb->nrofnotifies = 0;
+    dsb->fir_bank = NULL;
     dsb->device = device;
     DSOUND_RecalcFormat(dsb);
 
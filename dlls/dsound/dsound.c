@@ -233,8 +233,9 @@ static ULONG DirectSoundDevice_Release(DirectSoundDevice * device)
         if(device->mmdevice)
             IMMDevice_Release(device->mmdevice);
         CloseHandle(device->sleepev);
-        HeapFree(GetProcessHeap(), 0, device->tmp_buffer);
-        HeapFree(GetProcessHeap(), 0, device->cp_buffer);
+        DSOUND_DestroyMixWorkers(device);
+        HeapFree(GetProcessHeap(), 0, device->scratch.tmp_buffer);
+        HeapFree(GetProcessHeap(), 0, device->scratch.cp_buffer);
         HeapFree(GetProcessHeap(), 0, device->buffer);
         device->mixlock.DebugInfo->Spare[0] = 0;
         DeleteCriticalSection(&device->mixlock);
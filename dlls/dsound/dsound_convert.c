@@ -148,98 +148,96 @@ static inline LONG f_to_32(float value)
     return le32(lrintf(value * 0x80000000U));
 }
 
-void putieee32(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value)
+void putieee32(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value)
 {
-    BYTE *buf = (BYTE *)dsb->device->tmp_buffer;
-    float *fbuf = (float*)(buf + pos + sizeof(float) * channel);
+    float *fbuf = (float*)((BYTE *)buf + pos + sizeof(float) * channel);
     *fbuf = value;
 }
 
-void putieee32_sum(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value)
+void putieee32_sum(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value)
 {
-    BYTE *buf = (BYTE *)dsb->device->tmp_buffer;
-    float *fbuf = (float*)(buf + pos + sizeof(float) * channel);
+    float *fbuf = (float*)((BYTE *)buf + pos + sizeof(float) * channel);
     *fbuf += value;
 }
 
-void put_mono2stereo(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value)
+void put_mono2stereo(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value)
 {
-    dsb->put_aux(dsb, pos, 0, value);
-    dsb->put_aux(dsb, pos, 1, value);
+    dsb->put_aux(dsb, buf, pos, 0, value);
+    dsb->put_aux(dsb, buf, pos, 1, value);
 }
 
-void put_mono2quad(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value)
+void put_mono2quad(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value)
 {
-    dsb->put_aux(dsb, pos, 0, value);
-    dsb->put_aux(dsb, pos, 1, value);
-    dsb->put_aux(dsb, pos, 2, value);
-    dsb->put_aux(dsb, pos, 3, value);
+    dsb->put_aux(dsb, buf, pos, 0, value);
+    dsb->put_aux(dsb, buf, pos, 1, value);
+    dsb->put_aux(dsb, buf, pos, 2, value);
+    dsb->put_aux(dsb, buf, pos, 3, value);
 }
 
-void put_stereo2quad(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value)
+void put_stereo2quad(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value)
 {
     if (channel == 0) { /* Left */
-        dsb->put_aux(dsb, pos, 0, value); /* Front left */
-        dsb->put_aux(dsb, pos, 2, value); /* Back left */
+        dsb->put_aux(dsb, buf, pos, 0, value); /* Front left */
+        dsb->put_aux(dsb, buf, pos, 2, value); /* Back left */
     } else if (channel == 1) { /* Right */
-        dsb->put_aux(dsb, pos, 1, value); /* Front right */
-        dsb->put_aux(dsb, pos, 3, value); /* Back right */
+        dsb->put_aux(dsb, buf, pos, 1, value); /* Front right */
+        dsb->put_aux(dsb, buf, pos, 3, value); /* Back right */
     }
 }
 
-void put_mono2surround51(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value)
+void put_mono2surround51(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value)
 {
-    dsb->put_aux(dsb, pos, 0, value);
-    dsb->put_aux(dsb, pos, 1, value);
-    dsb->put_aux(dsb, pos, 2, value);
-    dsb->put_aux(dsb, pos, 3, value);
-    dsb->put_aux(dsb, pos, 4, value);
-    dsb->put_aux(dsb, pos, 5, value);
+    dsb->put_aux(dsb, buf, pos, 0, value);
+    dsb->put_aux(dsb, buf, pos, 1, value);
+    dsb->put_aux(dsb, buf, pos, 2, value);
+    dsb->put_aux(dsb, buf, pos, 3, value);
+    dsb->put_aux(dsb, buf, pos, 4, value);
+    dsb->put_aux(dsb, buf, pos, 5, value);
 }
 
-void put_stereo2surround51(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value)
+void put_stereo2surround51(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value)
 {
     if (channel == 0) { /* Left */
-        dsb->put_aux(dsb, pos, 0, value); /* Front left */
-        dsb->put_aux(dsb, pos, 4, value); /* Back left */
+        dsb->put_aux(dsb, buf, pos, 0, value); /* Front left */
+        dsb->put_aux(dsb, buf, pos, 4, value); /* Back left */
 
-        dsb->put_aux(dsb, pos, 2, 0.0f); /* Mute front centre */
-        dsb->put_aux(dsb, pos, 3, 0.0f); /* Mute LFE */
+        dsb->put_aux(dsb, buf, pos, 2, 0.0f); /* Mute front centre */
+        dsb->put_aux(dsb, buf, pos, 3, 0.0f); /* Mute LFE */
     } else if (channel == 1) { /* Right */
-        dsb->put_aux(dsb, pos, 1, value); /* Front right */
-        dsb->put_aux(dsb, pos, 5, value); /* Back right */
+        dsb->put_aux(dsb, buf, pos, 1, value); /* Front right */
+        dsb->put_aux(dsb, buf, pos, 5, value); /* Back right */
     }
 }
 
-void put_surround512stereo(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value)
+void put_surround512stereo(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value)
 {
     /* based on analyzing a recording of a dsound downmix */
     switch(channel){
 
     case 4: /* surround left */
         value *= 0.24f;
-        dsb->put_aux(dsb, pos, 0, value);
+        dsb->put_aux(dsb, buf, pos, 0, value);
         break;
 
     case 0: /* front left */
         value *= 1.0f;
-        dsb->put_aux(dsb, pos, 0, value);
+        dsb->put_aux(dsb, buf, pos, 0, value);
         break;
 
     case 5: /* surround right */
         value *= 0.24f;
-        dsb->put_aux(dsb, pos, 1, value);
+        dsb->put_aux(dsb, buf, pos, 1, value);
         break;
 
     case 1: /* front right */
         value *= 1.0f;
-        dsb->put_aux(dsb, pos, 1, value);
+        dsb->put_aux(dsb, buf, pos, 1, value);
         break;
 
     case 2: /* centre */
         value *= 0.7;
-        dsb->put_aux(dsb, pos, 0, value);
-        dsb->put_aux(dsb, pos, 1, value);
+        dsb->put_aux(dsb, buf, pos, 0, value);
+        dsb->put_aux(dsb, buf, pos, 1, value);
         break;
 
     case 3:
@@ -248,45 +246,45 @@ void put_surround512stereo(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD c
     }
 }
 
-void put_surround712stereo(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value)
+void put_surround712stereo(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value)
 {
     /* based on analyzing a recording of a dsound downmix */
     switch(channel){
 
     case 6: /* back left */
         value *= 0.24f;
-        dsb->put_aux(dsb, pos, 0, value);
+        dsb->put_aux(dsb, buf, pos, 0, value);
         break;
 
     case 4: /* surround left */
         value *= 0.24f;
-        dsb->put_aux(dsb, pos, 0, value);
+        dsb->put_aux(dsb, buf, pos, 0, value);
         break;
 
     case 0: /* front left */
         value *= 1.0f;
-        dsb->put_aux(dsb, pos, 0, value);
+        dsb->put_aux(dsb, buf, pos, 0, value);
         break;
 
     case 7: /* back right */
         value *= 0.24f;
-        dsb->put_aux(dsb, pos, 1, value);
+        dsb->put_aux(dsb, buf, pos, 1, value);
         break;
 
     case 5: /* surround right */
         value *= 0.24f;
-        dsb->put_aux(dsb, pos, 1, value);
+        dsb->put_aux(dsb, buf, pos, 1, value);
         break;
 
     case 1: /* front right */
         value *= 1.0f;
-        dsb->put_aux(dsb, pos, 1, value);
+        dsb->put_aux(dsb, buf, pos, 1, value);
         break;
 
     case 2: /* centre */
         value *= 0.7;
-        dsb->put_aux(dsb, pos, 0, value);
-        dsb->put_aux(dsb, pos, 1, value);
+        dsb->put_aux(dsb, buf, pos, 0, value);
+        dsb->put_aux(dsb, buf, pos, 1, value);
         break;
 
     case 3:
@@ -295,29 +293,29 @@ void put_surround712stereo(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD c
     }
 }
 
-void put_quad2stereo(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value)
+void put_quad2stereo(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value)
 {
     /* based on pulseaudio's downmix algorithm */
     switch(channel){
 
     case 2: /* back left */
         value *= 0.1f; /* (1/9) / (sum of left volumes) */
-        dsb->put_aux(dsb, pos, 0, value);
+        dsb->put_aux(dsb, buf, pos, 0, value);
         break;
 
     case 0: /* front left */
         value *= 0.9f; /* 1 / (sum of left volumes) */
-        dsb->put_aux(dsb, pos, 0, value);
+        dsb->put_aux(dsb, buf, pos, 0, value);
         break;
 
     case 3: /* back right */
         value *= 0.1f; /* (1/9) / (sum of right volumes) */
-        dsb->put_aux(dsb, pos, 1, value);
+        dsb->put_aux(dsb, buf, pos, 1, value);
         break;
 
     case 1: /* front right */
         value *= 0.9f; /* 1 / (sum of right volumes) */
-        dsb->put_aux(dsb, pos, 1, value);
+        dsb->put_aux(dsb, buf, pos, 1, value);
         break;
     }
 }
@@ -33,6 +33,9 @@
 #include "wine/list.h"
 
 #define DS_MAX_CHANNELS 6
+#define DS_MAX_FIR_PHASES 1024 /* Largest number of precomputed resampler filter slices */
+#define DS_MAX_MIX_WORKERS 3 /* Largest number of threads mixing alongside the mixer thread */
+#define DS_MIX_GROUP_SIZE 16 /* Smallest number of playing buffers mixed by one thread */
 
 extern int ds_hel_buflen DECLSPEC_HIDDEN;
 
@@ -44,10 +47,10 @@ typedef struct DirectSoundDevice             DirectSoundDevice;
 
 /* dsound_convert.h */
 typedef float (*bitsgetfunc)(const IDirectSoundBufferImpl *, DWORD, DWORD);
-typedef void (*bitsputfunc)(const IDirectSoundBufferImpl *, DWORD, DWORD, float);
+typedef void (*bitsputfunc)(const IDirectSoundBufferImpl *, float *, DWORD, DWORD, float);
 extern const bitsgetfunc getbpp[5] DECLSPEC_HIDDEN;
-void putieee32(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
-void putieee32_sum(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
+void putieee32(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
+void putieee32_sum(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
 void mixieee32(float *src, float *dst, unsigned samples) DECLSPEC_HIDDEN;
 typedef void (*normfunc)(const void *, void *, unsigned);
 extern const normfunc normfunctions[4] DECLSPEC_HIDDEN;
@@ -59,6 +62,15 @@ typedef struct _DSVOLUMEPAN
     LONG	lPan;
 } DSVOLUMEPAN,*PDSVOLUMEPAN;
 
+/* Scratch space used while mixing a secondary buffer */
+struct dsound_mix_scratch
+{
+    float *tmp_buffer, *cp_buffer;
+    DWORD tmp_buffer_len, cp_buffer_len;
+};
+
+struct dsound_mix_worker;
+
 typedef struct DSFilter {
     GUID guid;
     IMediaObject* obj;
@@ -88,8 +100,9 @@ struct DirectSoundDevice
     int                         speaker_num[DS_MAX_CHANNELS];
     int                         num_speakers;
     int                         lfe_channel;
-    float *tmp_buffer, *cp_buffer;
-    DWORD                       tmp_buffer_len, cp_buffer_len;
+    struct dsound_mix_scratch   scratch;
+    struct dsound_mix_worker   *mix_workers;
+    unsigned int                mix_worker_count;
 
     DSVOLUMEPAN                 volpan;
 
@@ -151,6 +164,10 @@ struct IDirectSoundBufferImpl
     float                       firgain;
     LONG64                      freqAdjustNum,freqAdjustDen;
     LONG64                      freqAccNum;
+    /* Precomputed FIR slices, one per resampling phase */
+    float                       *fir_bank;
+    UINT                        *fir_bank_taps;
+    UINT                        fir_bank_phases, fir_bank_stride, fir_bank_gcd;
     /* used for mixing */
     DWORD                       sec_mixpos;
 
@@ -172,14 +189,14 @@ struct IDirectSoundBufferImpl
 };
 
 float get_mono(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel) DECLSPEC_HIDDEN;
-void put_mono2stereo(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
-void put_mono2quad(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
-void put_stereo2quad(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
-void put_mono2surround51(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
-void put_stereo2surround51(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
-void put_surround512stereo(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
-void put_surround712stereo(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
-void put_quad2stereo(const IDirectSoundBufferImpl *dsb, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
+void put_mono2stereo(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
+void put_mono2quad(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
+void put_stereo2quad(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
+void put_mono2surround51(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
+void put_stereo2surround51(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
+void put_surround512stereo(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
+void put_surround712stereo(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
+void put_quad2stereo(const IDirectSoundBufferImpl *dsb, float *buf, DWORD pos, DWORD channel, float value) DECLSPEC_HIDDEN;
 
 HRESULT secondarybuffer_create(DirectSoundDevice *device, const DSBUFFERDESC *dsbd,
         IDirectSoundBuffer **buffer) DECLSPEC_HIDDEN;
@@ -228,6 +245,7 @@ void DSOUND_RecalcFormat(IDirectSoundBufferImpl *dsb) DECLSPEC_HIDDEN;
 DWORD DSOUND_secpos_to_bufpos(const IDirectSoundBufferImpl *dsb, DWORD secpos, DWORD secmixpos, float *overshot) DECLSPEC_HIDDEN;
 
 DWORD CALLBACK DSOUND_mixthread(void *ptr) DECLSPEC_HIDDEN;
+void DSOUND_DestroyMixWorkers(DirectSoundDevice *device) DECLSPEC_HIDDEN;
 
 /* sound3d.c */
 
@@ -127,6 +127,10 @@ void DSOUND_RecalcFormat(IDirectSoundBufferImpl *dsb)
 	}
 	dsb->firgain = (float)dsb->firstep / fir_step;
 
+	/* The filter slices depend on the frequencies, rebuild them on demand. */
+	HeapFree(GetProcessHeap(), 0, dsb->fir_bank);
+	dsb->fir_bank = NULL;
+
 	/* calculate the 10ms write lead */
 	dsb->writelead = (dsb->freq / 100) * dsb->pwfx->nBlockAlign;
 
@@ -283,19 +287,111 @@ static inline float get_current_sample(const IDirectSoundBufferImpl *dsb,
     return dsb->get(dsb, mixpos % dsb->buflen, channel);
 }
 
-static UINT cp_fields_noresample(IDirectSoundBufferImpl *dsb, UINT count)
+static UINT cp_fields_noresample(IDirectSoundBufferImpl *dsb, float *buf, UINT count)
 {
     UINT istride = dsb->pwfx->nBlockAlign;
     UINT ostride = dsb->device->pwfx->nChannels * sizeof(float);
     DWORD channel, i;
     for (i = 0; i < count; i++)
         for (channel = 0; channel < dsb->mix_channels; channel++)
-            dsb->put(dsb, i * ostride, channel, get_current_sample(dsb,
+            dsb->put(dsb, buf, i * ostride, channel, get_current_sample(dsb,
                     dsb->sec_mixpos + i * istride, channel));
     return count;
 }
 
-static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *freqAccNum)
+/**
+ * The FIR slice used for an output sample only depends on the position of
+ * that sample between two input samples, i.e. on freqAccNum modulo
+ * freqAdjustDen. Since freqAccNum only ever advances in steps of
+ * freqAdjustNum, there are freqAdjustDen / gcd(freqAdjustNum, freqAdjustDen)
+ * distinct slices, which can be computed once instead of once per sample.
+ */
+static BOOL init_fir_bank(IDirectSoundBufferImpl *dsb)
+{
+    UINT dsbfirstep = dsb->firstep;
+    UINT stride = (fir_len + dsbfirstep - 2) / dsbfirstep;
+    LONG64 a = dsb->freqAdjustNum, b = dsb->freqAdjustDen, t;
+    UINT phase, phases, idx, n;
+    LONG64 steps;
+    float rem, *slice;
+
+    if (dsb->fir_bank)
+        return TRUE;
+
+    while (b)
+    {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    if (!a || dsb->freqAdjustDen / a > DS_MAX_FIR_PHASES)
+        return FALSE;
+    phases = dsb->freqAdjustDen / a;
+
+    if (!(dsb->fir_bank = HeapAlloc(GetProcessHeap(), 0,
+            phases * (stride * sizeof(*dsb->fir_bank) + sizeof(*dsb->fir_bank_taps)))))
+        return FALSE;
+    dsb->fir_bank_taps = (UINT *)(dsb->fir_bank + phases * stride);
+    dsb->fir_bank_phases = phases;
+    dsb->fir_bank_stride = stride;
+    dsb->fir_bank_gcd = a;
+
+    for (phase = 0; phase < phases; ++phase)
+    {
+        steps = phase * a * dsbfirstep;
+        idx = dsbfirstep - steps / dsb->freqAdjustDen - 1;
+        rem = 1.0f - (float)(steps % dsb->freqAdjustDen) / dsb->freqAdjustDen;
+
+        slice = dsb->fir_bank + phase * stride;
+        for (n = 0; idx < fir_len - 1; idx += dsbfirstep)
+            slice[n++] = fir[idx] * (1.0 - rem) + fir[idx + 1] * rem;
+        dsb->fir_bank_taps[phase] = n;
+    }
+
+    TRACE("Precomputed %u filter slices for %s -> %s.\n", phases,
+            wine_dbgstr_longlong(dsb->freqAdjustNum), wine_dbgstr_longlong(dsb->freqAdjustDen));
+    return TRUE;
+}
+
+static void cp_fields_resample_bank(IDirectSoundBufferImpl *dsb, float *buf, UINT count,
+        LONG64 freqAcc_start, const float *intermediate, UINT required_input)
+{
+    UINT ostride = dsb->device->pwfx->nChannels * sizeof(float);
+    UINT step_int = dsb->freqAdjustNum / dsb->freqAdjustDen;
+    UINT step_frac = dsb->freqAdjustNum % dsb->freqAdjustDen;
+    UINT den = dsb->freqAdjustDen, gcd = dsb->fir_bank_gcd;
+    UINT frac = freqAcc_start, ipos = 0;
+    UINT i, channel, taps, j;
+    const float *slice, *cache;
+    float sum;
+
+    for (i = 0; i < count; ++i)
+    {
+        slice = dsb->fir_bank + (frac / gcd) * dsb->fir_bank_stride;
+        taps = dsb->fir_bank_taps[frac / gcd];
+
+        assert(ipos + taps <= required_input);
+
+        for (channel = 0; channel < dsb->mix_channels; ++channel)
+        {
+            cache = &intermediate[channel * required_input + ipos];
+            sum = 0.0f;
+            for (j = 0; j < taps; ++j)
+                sum += slice[j] * cache[j];
+            dsb->put(dsb, buf, i * ostride, channel, sum * dsb->firgain);
+        }
+
+        ipos += step_int;
+        if ((frac += step_frac) >= den)
+        {
+            frac -= den;
+            ++ipos;
+        }
+    }
+}
+
+static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, struct dsound_mix_scratch *scratch,
+        UINT count, LONG64 *freqAccNum)
 {
     UINT i, channel;
     UINT istride = dsb->pwfx->nBlockAlign;
@@ -315,15 +411,15 @@ static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *
     len += fir_cachesize;
     len *= sizeof(float);
 
-    if (!dsb->device->cp_buffer) {
-        dsb->device->cp_buffer = HeapAlloc(GetProcessHeap(), 0, len);
-        dsb->device->cp_buffer_len = len;
-    } else if (len > dsb->device->cp_buffer_len) {
-        dsb->device->cp_buffer = HeapReAlloc(GetProcessHeap(), 0, dsb->device->cp_buffer, len);
-        dsb->device->cp_buffer_len = len;
+    if (!scratch->cp_buffer) {
+        scratch->cp_buffer = HeapAlloc(GetProcessHeap(), 0, len);
+        scratch->cp_buffer_len = len;
+    } else if (len > scratch->cp_buffer_len) {
+        scratch->cp_buffer = HeapReAlloc(GetProcessHeap(), 0, scratch->cp_buffer, len);
+        scratch->cp_buffer_len = len;
     }
 
-    fir_copy = dsb->device->cp_buffer;
+    fir_copy = scratch->cp_buffer;
     intermediate = fir_copy + fir_cachesize;
 
 
@@ -337,6 +433,14 @@ static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *
             *(itmp++) = get_current_sample(dsb,
                     dsb->sec_mixpos + i * istride, channel);
 
+    if (freqAcc_start < dsb->freqAdjustDen && init_fir_bank(dsb)
+            && !(freqAcc_start % dsb->fir_bank_gcd))
+    {
+        cp_fields_resample_bank(dsb, scratch->tmp_buffer, count, freqAcc_start, intermediate, required_input);
+        *freqAccNum = freqAcc_end % dsb->freqAdjustDen;
+        return max_ipos;
+    }
+
     for(i = 0; i < count; ++i) {
         UINT int_fir_steps = (freqAcc_start + i * dsb->freqAdjustNum) * dsbfirstep / dsb->freqAdjustDen;
         float total_fir_steps = (freqAcc_start + i * dsb->freqAdjustNum) * dsbfirstep / (float)dsb->freqAdjustDen;
@@ -360,7 +464,7 @@ static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *
             float* cache = &intermediate[channel * required_input + ipos];
             for (j = 0; j < fir_used; j++)
                 sum += fir_copy[j] * cache[j];
-            dsb->put(dsb, i * ostride, channel, sum * dsb->firgain);
+            dsb->put(dsb, scratch->tmp_buffer, i * ostride, channel, sum * dsb->firgain);
         }
     }
 
@@ -369,14 +473,15 @@ static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *
     return max_ipos;
 }
 
-static void cp_fields(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *freqAccNum)
+static void cp_fields(IDirectSoundBufferImpl *dsb, struct dsound_mix_scratch *scratch,
+        UINT count, LONG64 *freqAccNum)
 {
     DWORD ipos, adv;
 
     if (dsb->freqAdjustNum == dsb->freqAdjustDen)
-        adv = cp_fields_noresample(dsb, count); /* *freqAccNum is unmodified */
+        adv = cp_fields_noresample(dsb, scratch->tmp_buffer, count); /* *freqAccNum is unmodified */
     else
-        adv = cp_fields_resample(dsb, count, freqAccNum);
+        adv = cp_fields_resample(dsb, scratch, count, freqAccNum);
 
     ipos = dsb->sec_mixpos + adv * dsb->pwfx->nBlockAlign;
     if (ipos >= dsb->buflen) {
@@ -419,29 +524,29 @@ static inline DWORD DSOUND_BufPtrDiff(DWORD buflen, DWORD ptr1, DWORD ptr2)
  *
  * NOTE: writepos + len <= buflen. When called by mixer, MixOne makes sure of this.
  */
-static void DSOUND_MixToTemporary(IDirectSoundBufferImpl *dsb, DWORD frames)
+static void DSOUND_MixToTemporary(IDirectSoundBufferImpl *dsb, struct dsound_mix_scratch *scratch, DWORD frames)
 {
 	UINT size_bytes = frames * sizeof(float) * dsb->device->pwfx->nChannels;
 	HRESULT hr;
 	int i;
 
-	if (dsb->device->tmp_buffer_len < size_bytes || !dsb->device->tmp_buffer)
+	if (scratch->tmp_buffer_len < size_bytes || !scratch->tmp_buffer)
 	{
-		dsb->device->tmp_buffer_len = size_bytes;
-		if (dsb->device->tmp_buffer)
-			dsb->device->tmp_buffer = HeapReAlloc(GetProcessHeap(), 0, dsb->device->tmp_buffer, size_bytes);
+		scratch->tmp_buffer_len = size_bytes;
+		if (scratch->tmp_buffer)
+			scratch->tmp_buffer = HeapReAlloc(GetProcessHeap(), 0, scratch->tmp_buffer, size_bytes);
 		else
-			dsb->device->tmp_buffer = HeapAlloc(GetProcessHeap(), 0, size_bytes);
+			scratch->tmp_buffer = HeapAlloc(GetProcessHeap(), 0, size_bytes);
 	}
 	if(dsb->put_aux == putieee32_sum)
-		memset(dsb->device->tmp_buffer, 0, dsb->device->tmp_buffer_len);
+		memset(scratch->tmp_buffer, 0, scratch->tmp_buffer_len);
 
-	cp_fields(dsb, frames, &dsb->freqAccNum);
+	cp_fields(dsb, scratch, frames, &dsb->freqAccNum);
 
 	if (size_bytes > 0) {
 		for (i = 0; i < dsb->num_filters; i++) {
 			if (dsb->filters[i].inplace) {
-				hr = IMediaObjectInPlace_Process(dsb->filters[i].inplace, size_bytes, (BYTE*)dsb->device->tmp_buffer, 0, DMO_INPLACE_NORMAL);
+				hr = IMediaObjectInPlace_Process(dsb->filters[i].inplace, size_bytes, (BYTE*)scratch->tmp_buffer, 0, DMO_INPLACE_NORMAL);
 
 				if (FAILED(hr))
 					WARN("IMediaObjectInPlace_Process failed for filter %u\n", i);
@@ -451,7 +556,7 @@ static void DSOUND_MixToTemporary(IDirectSoundBufferImpl *dsb, DWORD frames)
 	}
 }
 
-static void DSOUND_MixerVol(const IDirectSoundBufferImpl *dsb, INT frames)
+static void DSOUND_MixerVol(const IDirectSoundBufferImpl *dsb, float *buf, INT frames)
 {
 	INT	i;
 	float vols[DS_MAX_CHANNELS];
@@ -477,7 +582,7 @@ static void DSOUND_MixerVol(const IDirectSoundBufferImpl *dsb, INT frames)
 
 	for(i = 0; i < frames; ++i){
 		for(chan = 0; chan < channels; ++chan){
-			dsb->device->tmp_buffer[i * channels + chan] *= vols[chan];
+			buf[i * channels + chan] *= vols[chan];
 		}
 	}
 }
@@ -494,7 +599,8 @@ static void DSOUND_MixerVol(const IDirectSoundBufferImpl *dsb, INT frames)
  * dsb  = the secondary buffer to mix from
  * fraglen = number of bytes to mix
  */
-static DWORD DSOUND_MixInBuffer(IDirectSoundBufferImpl *dsb, float *mix_buffer, DWORD frames)
+static DWORD DSOUND_MixInBuffer(IDirectSoundBufferImpl *dsb, struct dsound_mix_scratch *scratch,
+        float *mix_buffer, DWORD frames)
 {
 	float *ibuf;
 	DWORD oldpos;
@@ -504,11 +610,11 @@ static DWORD DSOUND_MixInBuffer(IDirectSoundBufferImpl *dsb, float *mix_buffer,
 
 	/* Resample buffer to temporary buffer specifically allocated for this purpose, if needed */
 	oldpos = dsb->sec_mixpos;
-	DSOUND_MixToTemporary(dsb, frames);
-	ibuf = dsb->device->tmp_buffer;
+	DSOUND_MixToTemporary(dsb, scratch, frames);
+	ibuf = scratch->tmp_buffer;
 
 	/* Apply volume if needed */
-	DSOUND_MixerVol(dsb, frames);
+	DSOUND_MixerVol(dsb, ibuf, frames);
 
 	mixieee32(ibuf, mix_buffer, frames * dsb->device->pwfx->nChannels);
 
@@ -533,7 +639,8 @@ static DWORD DSOUND_MixInBuffer(IDirectSoundBufferImpl *dsb, float *mix_buffer,
  *
  * Returns: the number of frames beyond the writepos that were mixed.
  */
-static DWORD DSOUND_MixOne(IDirectSoundBufferImpl *dsb, float *mix_buffer, DWORD frames)
+static DWORD DSOUND_MixOne(IDirectSoundBufferImpl *dsb, struct dsound_mix_scratch *scratch,
+        float *mix_buffer, DWORD frames)
 {
 	DWORD primary_done = 0;
 
@@ -558,7 +665,7 @@ static DWORD DSOUND_MixOne(IDirectSoundBufferImpl *dsb, float *mix_buffer, DWORD
 	/* First try to mix to the end of the buffer if possible
 	 * Theoretically it would allow for better optimization
 	*/
-	primary_done += DSOUND_MixInBuffer(dsb, mix_buffer, frames);
+	primary_done += DSOUND_MixInBuffer(dsb, scratch, mix_buffer, frames);
 
 	TRACE("total mixed data=%d\n", primary_done);
 
@@ -567,16 +674,13 @@ static DWORD DSOUND_MixOne(IDirectSoundBufferImpl *dsb, float *mix_buffer, DWORD
 }
 
 /**
- * For a DirectSoundDevice, go through all the currently playing buffers and
- * mix them in to the device buffer.
+ * Mix the playing buffers device->buffers[first] to
+ * device->buffers[first + count - 1] into mix_buffer.
  *
- * frames = the maximum amount to mix into the primary buffer
  * all_stopped = reports back if all buffers have stopped
- *
- * Returns:  the length beyond the writepos that was mixed to.
  */
-
-static void DSOUND_MixToPrimary(const DirectSoundDevice *device, float *mix_buffer, DWORD frames, BOOL *all_stopped)
+static void DSOUND_MixBuffers(const DirectSoundDevice *device, struct dsound_mix_scratch *scratch,
+        float *mix_buffer, DWORD frames, int first, int count, BOOL *all_stopped)
 {
 	INT i;
 	IDirectSoundBufferImpl	*dsb;
@@ -584,8 +688,7 @@ static void DSOUND_MixToPrimary(const DirectSoundDevice *device, float *mix_buff
 	/* unless we find a running buffer, all have stopped */
 	*all_stopped = TRUE;
 
-	TRACE("(frames %d)\n", frames);
-	for (i = 0; i < device->nrofbuffers; i++) {
+	for (i = first; i < first + count; i++) {
 		dsb = device->buffers[i];
 
 		TRACE("MixToPrimary for %p, state=%d\n", dsb, dsb->state);
@@ -604,7 +707,7 @@ static void DSOUND_MixToPrimary(const DirectSoundDevice *device, float *mix_buff
 					dsb->state = STATE_PLAYING;
 
 				/* mix next buffer into the main buffer */
-				DSOUND_MixOne(dsb, mix_buffer, frames);
+				DSOUND_MixOne(dsb, scratch, mix_buffer, frames);
 
 				*all_stopped = FALSE;
 			}
@@ -613,6 +716,155 @@ static void DSOUND_MixToPrimary(const DirectSoundDevice *device, float *mix_buff
 	}
 }
 
+struct dsound_mix_worker
+{
+	const DirectSoundDevice *device;
+	TP_WORK *work;
+	struct dsound_mix_scratch scratch;
+	float *mix_buffer;
+	DWORD mix_buffer_len;
+	DWORD frames;
+	int first, count;
+	BOOL all_stopped;
+};
+
+static void CALLBACK DSOUND_MixWorker(TP_CALLBACK_INSTANCE *instance, void *context, TP_WORK *work)
+{
+	struct dsound_mix_worker *worker = context;
+
+	memset(worker->mix_buffer, 0, worker->frames * worker->device->pwfx->nChannels * sizeof(float));
+	DSOUND_MixBuffers(worker->device, &worker->scratch, worker->mix_buffer, worker->frames,
+			worker->first, worker->count, &worker->all_stopped);
+}
+
+void DSOUND_DestroyMixWorkers(DirectSoundDevice *device)
+{
+	unsigned int i;
+
+	for (i = 0; i < device->mix_worker_count; ++i)
+	{
+		struct dsound_mix_worker *worker = &device->mix_workers[i];
+
+		if (worker->work)
+			CloseThreadpoolWork(worker->work);
+		HeapFree(GetProcessHeap(), 0, worker->scratch.tmp_buffer);
+		HeapFree(GetProcessHeap(), 0, worker->scratch.cp_buffer);
+		HeapFree(GetProcessHeap(), 0, worker->mix_buffer);
+	}
+	HeapFree(GetProcessHeap(), 0, device->mix_workers);
+	device->mix_workers = NULL;
+	device->mix_worker_count = 0;
+}
+
+static unsigned int DSOUND_GetMixWorkers(DirectSoundDevice *device, DWORD frames, unsigned int count)
+{
+	DWORD size = frames * device->pwfx->nChannels * sizeof(float);
+	struct dsound_mix_worker *worker;
+	unsigned int i;
+
+	if (!device->mix_workers)
+	{
+		SYSTEM_INFO info;
+
+		GetSystemInfo(&info);
+		device->mix_worker_count = min(info.dwNumberOfProcessors - 1, DS_MAX_MIX_WORKERS);
+		if (!device->mix_worker_count || !(device->mix_workers = HeapAlloc(GetProcessHeap(),
+				HEAP_ZERO_MEMORY, device->mix_worker_count * sizeof(*device->mix_workers))))
+		{
+			device->mix_worker_count = 0;
+			return 0;
+		}
+	}
+
+	count = min(count, device->mix_worker_count);
+	for (i = 0; i < count; ++i)
+	{
+		worker = &device->mix_workers[i];
+		worker->device = device;
+		if (!worker->work && !(worker->work = CreateThreadpoolWork(DSOUND_MixWorker, worker, NULL)))
+			return i;
+		if (worker->mix_buffer_len < size)
+		{
+			HeapFree(GetProcessHeap(), 0, worker->mix_buffer);
+			worker->mix_buffer_len = 0;
+			if (!(worker->mix_buffer = HeapAlloc(GetProcessHeap(), 0, size)))
+				return i;
+			worker->mix_buffer_len = size;
+		}
+	}
+	return count;
+}
+
+/**
+ * For a DirectSoundDevice, go through all the currently playing buffers and
+ * mix them in to the device buffer.
+ *
+ * With many playing buffers, the buffers are split into groups which are
+ * mixed concurrently on the thread pool, each into its own accumulation
+ * buffer. The mixer thread mixes the first group itself and adds the other
+ * groups' results to the device buffer afterwards.
+ *
+ * frames = the maximum amount to mix into the primary buffer
+ * all_stopped = reports back if all buffers have stopped
+ */
+static void DSOUND_MixToPrimary(DirectSoundDevice *device, float *mix_buffer, DWORD frames, BOOL *all_stopped)
+{
+	int i, playing = 0, group, first, end, own_count = 0;
+	unsigned int worker_count, w;
+	struct dsound_mix_worker *worker;
+	IDirectSoundBufferImpl *dsb;
+
+	TRACE("(frames %d)\n", frames);
+
+	/* DMO filters expect to be called from a single thread. */
+	for (i = 0; i < device->nrofbuffers; i++) {
+		dsb = device->buffers[i];
+		if (dsb->num_filters)
+			break;
+		if (dsb->buflen && dsb->state)
+			++playing;
+	}
+
+	if (i < device->nrofbuffers || playing < 2 * DS_MIX_GROUP_SIZE
+			|| !(worker_count = DSOUND_GetMixWorkers(device, frames, playing / DS_MIX_GROUP_SIZE - 1))) {
+		DSOUND_MixBuffers(device, &device->scratch, mix_buffer, frames, 0, device->nrofbuffers, all_stopped);
+		return;
+	}
+
+	/* Split the buffer list into worker_count + 1 groups with about the
+	 * same number of playing buffers each. */
+	group = (playing + worker_count) / (worker_count + 1);
+	first = 0;
+	for (w = 0; w <= worker_count; ++w) {
+		for (end = first, playing = 0; end < device->nrofbuffers && (playing < group || w == worker_count); ++end) {
+			dsb = device->buffers[end];
+			if (dsb->buflen && dsb->state)
+				++playing;
+		}
+
+		if (!w) {
+			/* The first group is mixed by this thread, below. */
+			own_count = end;
+		} else {
+			worker = &device->mix_workers[w - 1];
+			worker->frames = frames;
+			worker->first = first;
+			worker->count = end - first;
+			SubmitThreadpoolWork(worker->work);
+		}
+		first = end;
+	}
+
+	DSOUND_MixBuffers(device, &device->scratch, mix_buffer, frames, 0, own_count, all_stopped);
+
+	for (w = 0; w < worker_count; ++w) {
+		worker = &device->mix_workers[w];
+		WaitForThreadpoolWorkCallbacks(worker->work, FALSE);
+		mixieee32(worker->mix_buffer, mix_buffer, frames * device->pwfx->nChannels);
+		*all_stopped &= worker->all_stopped;
+	}
+}
+
 /**
  * Add buffers to the emulated wave device system.
  *
@@ -656,8 +908,8 @@ static void DSOUND_WaveQueue(DirectSoundDevice *device, LPBYTE pos, DWORD bytes)
  * The mixing procedure goes:
  *
  * secondary->buffer (secondary format)
- *   =[Resample]=> device->tmp_buffer (float format)
- *   =[Volume]=> device->tmp_buffer (float format)
+ *   =[Resample]=> scratch->tmp_buffer (float format)
+ *   =[Volume]=> scratch->tmp_buffer (float format)
  *   =[Reformat]=> device->buffer (device format, skipped on float)
  */
 static void DSOUND_PerformMix(DirectSoundDevice *device)
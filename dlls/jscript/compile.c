@@ -101,6 +101,7 @@ static void dump_instr_arg(instr_arg_type_t type, instr_arg_t *arg)
     case ARG_ADDR:
         TRACE_(jscript_disas)("\t%u", arg->uint);
         break;
+    case ARG_CACHE:
     case ARG_FUNC:
     case ARG_NONE:
         break;
@@ -331,6 +332,59 @@ static HRESULT push_instr_uint_str(compiler_ctx_t *ctx, jsop_t op, unsigned arg1
     return S_OK;
 }
 
+static prop_cache_t *compiler_alloc_prop_cache(compiler_ctx_t *ctx, const WCHAR *name)
+{
+    prop_cache_t *cache;
+
+    cache = compiler_alloc(ctx->code, sizeof(*cache));
+    if(cache)
+        init_prop_cache(cache, name);
+    return cache;
+}
+
+/* Pushes instruction with a property name argument and a lookup cache for that name. */
+static HRESULT push_instr_bstr_cache(compiler_ctx_t *ctx, jsop_t op, const WCHAR *arg)
+{
+    prop_cache_t *cache;
+    unsigned instr;
+    WCHAR *str;
+
+    str = compiler_alloc_bstr(ctx, arg);
+    if(!str)
+        return E_OUTOFMEMORY;
+
+    cache = compiler_alloc_prop_cache(ctx, str);
+    if(!cache)
+        return E_OUTOFMEMORY;
+
+    instr = push_instr(ctx, op);
+    if(!instr)
+        return E_OUTOFMEMORY;
+
+    instr_ptr(ctx, instr)->u.arg[0].bstr = str;
+    instr_ptr(ctx, instr)->u.arg[1].cache = cache;
+    return S_OK;
+}
+
+/* Pushes instruction with an unsigned argument and a lookup cache for given property name,
+   if it's known at compile time. */
+static HRESULT push_instr_uint_cache(compiler_ctx_t *ctx, jsop_t op, unsigned arg, const WCHAR *name)
+{
+    prop_cache_t *cache = NULL;
+    unsigned instr;
+
+    if(name && !(cache = compiler_alloc_prop_cache(ctx, name)))
+        return E_OUTOFMEMORY;
+
+    instr = push_instr(ctx, op);
+    if(!instr)
+        return E_OUTOFMEMORY;
+
+    instr_ptr(ctx, instr)->u.arg[0].uint = arg;
+    instr_ptr(ctx, instr)->u.arg[1].cache = cache;
+    return S_OK;
+}
+
 static HRESULT push_instr_double(compiler_ctx_t *ctx, jsop_t op, double arg)
 {
     unsigned instr;
@@ -395,7 +449,7 @@ static HRESULT compile_member_expression(compiler_ctx_t *ctx, member_expression_
     if(FAILED(hres))
         return hres;
 
-    return push_instr_bstr(ctx, OP_member, expr->identifier);
+    return push_instr_bstr_cache(ctx, OP_member, expr->identifier);
 }
 
 #define LABEL_FLAG 0x80000000
@@ -463,7 +517,7 @@ static HRESULT emit_identifier(compiler_ctx_t *ctx, const WCHAR *identifier)
     int local_ref;
     if(bind_local(ctx, identifier, &local_ref))
         return push_instr_int(ctx, OP_local, local_ref);
-    return push_instr_bstr(ctx, OP_ident, identifier);
+    return push_instr_bstr_cache(ctx, OP_ident, identifier);
 }
 
 static HRESULT compile_memberid_expression(compiler_ctx_t *ctx, expression_t *expr, unsigned flags)
@@ -488,7 +542,7 @@ static HRESULT compile_memberid_expression(compiler_ctx_t *ctx, expression_t *ex
         if(FAILED(hres))
             return hres;
 
-        hres = push_instr_uint(ctx, OP_memberid, flags);
+        hres = push_instr_uint_cache(ctx, OP_memberid, flags, NULL);
         break;
     }
     case EXPR_MEMBER: {
@@ -508,7 +562,7 @@ static HRESULT compile_memberid_expression(compiler_ctx_t *ctx, expression_t *ex
         if(FAILED(hres))
             return hres;
 
-        hres = push_instr_uint(ctx, OP_memberid, flags);
+        hres = push_instr_uint_cache(ctx, OP_memberid, flags, member_expr->identifier);
         break;
     }
     DEFAULT_UNREACHABLE;
@@ -529,6 +583,23 @@ static HRESULT compile_increment_expression(compiler_ctx_t *ctx, unary_expressio
         return push_instr_uint(ctx, OP_throw_ref, JS_E_ILLEGAL_ASSIGN);
     }
 
+    if(expr->expression->type == EXPR_IDENT) {
+        identifier_expression_t *ident_expr = (identifier_expression_t*)expr->expression;
+        int local_ref;
+
+        if(bind_local(ctx, ident_expr->identifier, &local_ref)) {
+            unsigned instr;
+
+            instr = push_instr(ctx, op == OP_postinc ? OP_postinc_local : OP_preinc_local);
+            if(!instr)
+                return E_OUTOFMEMORY;
+
+            instr_ptr(ctx, instr)->u.arg[0].lng = local_ref;
+            instr_ptr(ctx, instr)->u.arg[1].lng = n;
+            return S_OK;
+        }
+    }
+
     hres = compile_memberid_expression(ctx, expr->expression, fdexNameEnsure);
     if(FAILED(hres))
         return hres;
@@ -1182,20 +1253,74 @@ static HRESULT compile_expression_statement(compiler_ctx_t *ctx, expression_stat
     return !ctx->from_eval || push_instr(ctx, OP_setret) ? S_OK : E_OUTOFMEMORY;
 }
 
+/* Compiles condition followed by a jump taken if it's false. Relational expressions are
+ * compiled into a single compare and jump instruction. */
+static HRESULT compile_jmp_z(compiler_ctx_t *ctx, expression_t *expr, unsigned addr, unsigned *ret)
+{
+    binary_expression_t *binary_expr;
+    unsigned instr;
+    jsop_t op;
+    HRESULT hres;
+
+    switch(expr->type) {
+    case EXPR_LESS:
+        op = OP_lt;
+        break;
+    case EXPR_LESSEQ:
+        op = OP_lteq;
+        break;
+    case EXPR_GREATER:
+        op = OP_gt;
+        break;
+    case EXPR_GREATEREQ:
+        op = OP_gteq;
+        break;
+    default:
+        hres = compile_expression(ctx, expr, TRUE);
+        if(FAILED(hres))
+            return hres;
+
+        instr = push_instr(ctx, OP_jmp_z);
+        if(!instr)
+            return E_OUTOFMEMORY;
+
+        set_arg_uint(ctx, instr, addr);
+        if(ret)
+            *ret = instr;
+        return S_OK;
+    }
+
+    binary_expr = (binary_expression_t*)expr;
+
+    hres = compile_expression(ctx, binary_expr->expression1, TRUE);
+    if(FAILED(hres))
+        return hres;
+
+    hres = compile_expression(ctx, binary_expr->expression2, TRUE);
+    if(FAILED(hres))
+        return hres;
+
+    instr = push_instr(ctx, OP_cmp_jmp_z);
+    if(!instr)
+        return E_OUTOFMEMORY;
+
+    instr_ptr(ctx, instr)->u.arg[0].uint = addr;
+    instr_ptr(ctx, instr)->u.arg[1].uint = op;
+    if(ret)
+        *ret = instr;
+    return S_OK;
+}
+
 /* ECMA-262 3rd Edition    12.5 */
 static HRESULT compile_if_statement(compiler_ctx_t *ctx, if_statement_t *stat)
 {
     unsigned jmp_else;
     HRESULT hres;
 
-    hres = compile_expression(ctx, stat->expr, TRUE);
+    hres = compile_jmp_z(ctx, stat->expr, 0, &jmp_else);
     if(FAILED(hres))
         return hres;
 
-    jmp_else = push_instr(ctx, OP_jmp_z);
-    if(!jmp_else)
-        return E_OUTOFMEMORY;
-
     hres = compile_statement(ctx, NULL, stat->if_stat);
     if(FAILED(hres))
         return hres;
@@ -1240,11 +1365,7 @@ static HRESULT compile_while_statement(compiler_ctx_t *ctx, while_statement_t *s
 
     if(!stat->do_while) {
         label_set_addr(ctx, stat_ctx.continue_label);
-        hres = compile_expression(ctx, stat->expr, TRUE);
-        if(FAILED(hres))
-            return hres;
-
-        hres = push_instr_uint(ctx, OP_jmp_z, stat_ctx.break_label);
+        hres = compile_jmp_z(ctx, stat->expr, stat_ctx.break_label, NULL);
         if(FAILED(hres))
             return hres;
     }
@@ -1256,11 +1377,7 @@ static HRESULT compile_while_statement(compiler_ctx_t *ctx, while_statement_t *s
     set_compiler_loc(ctx, stat->stat.loc);
     if(stat->do_while) {
         label_set_addr(ctx, stat_ctx.continue_label);
-        hres = compile_expression(ctx, stat->expr, TRUE);
-        if(FAILED(hres))
-            return hres;
-
-        hres = push_instr_uint(ctx, OP_jmp_z, stat_ctx.break_label);
+        hres = compile_jmp_z(ctx, stat->expr, stat_ctx.break_label, NULL);
         if(FAILED(hres))
             return hres;
     }
@@ -1302,11 +1419,7 @@ static HRESULT compile_for_statement(compiler_ctx_t *ctx, for_statement_t *stat)
 
     if(stat->expr) {
         set_compiler_loc(ctx, stat->expr_loc);
-        hres = compile_expression(ctx, stat->expr, TRUE);
-        if(FAILED(hres))
-            return hres;
-
-        hres = push_instr_uint(ctx, OP_jmp_z, stat_ctx.break_label);
+        hres = compile_jmp_z(ctx, stat->expr, stat_ctx.break_label, NULL);
         if(FAILED(hres))
             return hres;
     }
@@ -1781,7 +1781,7 @@ HRESULT create_dispex(script_ctx_t *ctx, const builtin_info_t *builtin_info, jsd
     return S_OK;
 }
 
-void jsdisp_free(jsdisp_t *obj)
+static void destroy_jsdisp(jsdisp_t *obj)
 {
     dispex_prop_t *prop;
 
@@ -1814,6 +1814,52 @@ void jsdisp_free(jsdisp_t *obj)
         heap_free(obj);
 }
 
+static BOOL queue_free(script_ctx_t *ctx, jsdisp_t *obj)
+{
+    if(ctx->free_queue_len == ctx->free_queue_size) {
+        unsigned new_size = ctx->free_queue_size ? ctx->free_queue_size*2 : 32;
+        jsdisp_t **new_queue;
+
+        new_queue = heap_realloc(ctx->free_queue, new_size*sizeof(*new_queue));
+        if(!new_queue)
+            return FALSE;
+
+        ctx->free_queue = new_queue;
+        ctx->free_queue_size = new_size;
+    }
+
+    ctx->free_queue[ctx->free_queue_len++] = obj;
+    return TRUE;
+}
+
+/*
+ * Releasing an object releases everything it references, so dropping the last
+ * reference to a long chain of objects would recurse once per object. Objects
+ * whose refcount drops to zero while we're already destroying one are queued
+ * instead and destroyed iteratively, so the stack depth stays bounded no matter
+ * the shape of the object graph.
+ */
+void jsdisp_free(jsdisp_t *obj)
+{
+    script_ctx_t *ctx = obj->ctx;
+
+    if(ctx->freeing_objects) {
+        if(!queue_free(ctx, obj))
+            destroy_jsdisp(obj);
+        return;
+    }
+
+    script_addref(ctx);
+    ctx->freeing_objects = TRUE;
+
+    destroy_jsdisp(obj);
+    while(ctx->free_queue_len)
+        destroy_jsdisp(ctx->free_queue[--ctx->free_queue_len]);
+
+    ctx->freeing_objects = FALSE;
+    script_release(ctx);
+}
+
 #ifdef TRACE_REFCNT
 
 jsdisp_t *jsdisp_addref(jsdisp_t *jsdisp)
@@ -1895,6 +1941,47 @@ HRESULT jsdisp_get_id(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *
     return DISP_E_UNKNOWNNAME;
 }
 
+void init_prop_cache(prop_cache_t *cache, const WCHAR *name)
+{
+    cache->obj = NULL;
+    cache->id = DISPID_UNKNOWN;
+    cache->hash = string_hash(name);
+}
+
+/* Same as jsdisp_get_id, but repeated lookups of the same name on the same object skip
+ * the hash table and lookups on other objects reuse the precomputed name hash. */
+HRESULT jsdisp_get_id_cached(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, prop_cache_t *cache, DISPID *id)
+{
+    dispex_prop_t *prop;
+    HRESULT hres;
+
+    if(cache->obj == jsdisp && cache->id > 0 && cache->id < jsdisp->prop_cnt) {
+        prop = jsdisp->props + cache->id;
+        if(prop->type != PROP_DELETED && !wcscmp(prop->name, name)) {
+            *id = cache->id;
+            return S_OK;
+        }
+    }
+
+    if(flags & fdexNameEnsure)
+        hres = ensure_prop_name(jsdisp, name, PROPF_ENUMERABLE | PROPF_CONFIGURABLE | PROPF_WRITABLE,
+                                &prop);
+    else
+        hres = find_prop_name_prot(jsdisp, cache->hash, name, &prop);
+    if(FAILED(hres))
+        return hres;
+
+    if(prop && prop->type!=PROP_DELETED) {
+        cache->obj = jsdisp;
+        cache->id = *id = prop_to_id(jsdisp, prop);
+        return S_OK;
+    }
+
+    TRACE("not found %s\n", debugstr_w(name));
+    *id = DISPID_UNKNOWN;
+    return DISP_E_UNKNOWNNAME;
+}
+
 HRESULT jsdisp_call_value(jsdisp_t *jsfunc, IDispatch *jsthis, WORD flags, unsigned argc, jsval_t *argv, jsval_t *r)
 {
     HRESULT hres;
@@ -454,6 +454,42 @@ static HRESULT disp_get_id(script_ctx_t *ctx, IDispatch *disp, const WCHAR *name
     return hres;
 }
 
+static HRESULT disp_get_id_cached(script_ctx_t *ctx, IDispatch *disp, const WCHAR *name, BSTR name_bstr, DWORD flags,
+        prop_cache_t *cache, DISPID *id)
+{
+    jsdisp_t *jsdisp;
+    HRESULT hres;
+
+    if(!cache || !(jsdisp = iface_to_jsdisp(disp)))
+        return disp_get_id(ctx, disp, name, name_bstr, flags, id);
+
+    hres = jsdisp_get_id_cached(jsdisp, name, flags, cache, id);
+    jsdisp_release(jsdisp);
+    return hres;
+}
+
+/* Array elements are accessed by index names, format them without allocating a string. */
+static const WCHAR *index_name(jsval_t v, WCHAR *buf)
+{
+    WCHAR *ptr = buf + 11;
+    double n;
+    DWORD idx;
+
+    if(!is_number(v))
+        return NULL;
+
+    n = get_number(v);
+    if(!(n >= 0 && n < 4294967296.0) || (idx = n) != n)
+        return NULL;
+
+    *ptr = 0;
+    do {
+        *--ptr = '0' + idx % 10;
+        idx /= 10;
+    }while(idx);
+    return ptr;
+}
+
 static HRESULT disp_cmp(IDispatch *disp1, IDispatch *disp2, BOOL *ret)
 {
     IObjectIdentity *identity;
@@ -617,8 +653,15 @@ local_ref_t *lookup_local(const function_code_t *function, const WCHAR *identifi
     return bsearch(identifier, function->locals, function->locals_cnt, sizeof(*function->locals), local_ref_cmp);
 }
 
+static inline HRESULT scope_get_id(jsdisp_t *jsdisp, BSTR identifier, DWORD flags, prop_cache_t *cache, DISPID *id)
+{
+    if(cache)
+        return jsdisp_get_id_cached(jsdisp, identifier, flags, cache, id);
+    return jsdisp_get_id(jsdisp, identifier, flags, id);
+}
+
 /* ECMA-262 3rd Edition    10.1.4 */
-static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *ret)
+static HRESULT identifier_eval_cached(script_ctx_t *ctx, BSTR identifier, prop_cache_t *cache, exprval_t *ret)
 {
     scope_chain_t *scope;
     named_item_t *item;
@@ -648,7 +691,7 @@ static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *re
                 }
             }
             if(scope->jsobj)
-                hres = jsdisp_get_id(scope->jsobj, identifier, fdexNameImplicit, &id);
+                hres = scope_get_id(scope->jsobj, identifier, fdexNameImplicit, cache, &id);
             else
                 hres = disp_get_id(ctx, scope->obj, identifier, identifier, fdexNameImplicit, &id);
             if(SUCCEEDED(hres)) {
@@ -659,7 +702,7 @@ static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *re
 
         item = ctx->call_ctx->bytecode->named_item;
         if(item) {
-            hres = jsdisp_get_id(item->script_obj, identifier, 0, &id);
+            hres = scope_get_id(item->script_obj, identifier, 0, cache, &id);
             if(SUCCEEDED(hres)) {
                 exprval_set_disp_ref(ret, to_disp(item->script_obj), id);
                 return S_OK;
@@ -674,7 +717,7 @@ static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *re
         }
     }
 
-    hres = jsdisp_get_id(ctx->global, identifier, 0, &id);
+    hres = scope_get_id(ctx->global, identifier, 0, cache, &id);
     if(SUCCEEDED(hres)) {
         exprval_set_disp_ref(ret, to_disp(ctx->global), id);
         return S_OK;
@@ -695,6 +738,11 @@ static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *re
     return S_OK;
 }
 
+static inline HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *ret)
+{
+    return identifier_eval_cached(ctx, identifier, NULL, ret);
+}
+
 static inline BSTR get_op_bstr(script_ctx_t *ctx, int i)
 {
     call_frame_t *frame = ctx->call_ctx;
@@ -713,6 +761,12 @@ static inline unsigned get_op_int(script_ctx_t *ctx, int i)
     return frame->bytecode->instrs[frame->ip].u.arg[i].lng;
 }
 
+static inline prop_cache_t *get_op_cache(script_ctx_t *ctx, int i)
+{
+    call_frame_t *frame = ctx->call_ctx;
+    return frame->bytecode->instrs[frame->ip].u.arg[i].cache;
+}
+
 static inline jsstr_t *get_op_str(script_ctx_t *ctx, int i)
 {
     call_frame_t *frame = ctx->call_ctx;
@@ -1039,10 +1093,11 @@ static HRESULT interp_func(script_ctx_t *ctx)
 /* ECMA-262 3rd Edition    11.2.1 */
 static HRESULT interp_array(script_ctx_t *ctx)
 {
-    jsstr_t *name_str;
+    jsstr_t *name_str = NULL;
     const WCHAR *name;
     jsval_t v, namev;
     IDispatch *obj;
+    WCHAR buf[12];
     DISPID id;
     HRESULT hres;
 
@@ -1056,7 +1111,8 @@ static HRESULT interp_array(script_ctx_t *ctx)
         return hres;
     }
 
-    hres = to_flat_string(ctx, namev, &name_str, &name);
+    if(!(name = index_name(namev, buf)))
+        hres = to_flat_string(ctx, namev, &name_str, &name);
     jsval_release(namev);
     if(FAILED(hres)) {
         IDispatch_Release(obj);
@@ -1064,7 +1120,8 @@ static HRESULT interp_array(script_ctx_t *ctx)
     }
 
     hres = disp_get_id(ctx, obj, name, NULL, 0, &id);
-    jsstr_release(name_str);
+    if(name_str)
+        jsstr_release(name_str);
     if(SUCCEEDED(hres)) {
         hres = disp_propget(ctx, obj, id, &v);
     }else if(hres == DISP_E_UNKNOWNNAME) {
@@ -1082,6 +1139,7 @@ static HRESULT interp_array(script_ctx_t *ctx)
 static HRESULT interp_member(script_ctx_t *ctx)
 {
     const BSTR arg = get_op_bstr(ctx, 0);
+    prop_cache_t *cache = get_op_cache(ctx, 1);
     IDispatch *obj;
     jsval_t v;
     DISPID id;
@@ -1093,7 +1151,7 @@ static HRESULT interp_member(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, arg, arg, 0, &id);
+    hres = disp_get_id_cached(ctx, obj, arg, arg, 0, cache, &id);
     if(SUCCEEDED(hres)) {
         hres = disp_propget(ctx, obj, id, &v);
     }else if(hres == DISP_E_UNKNOWNNAME) {
@@ -1111,10 +1169,12 @@ static HRESULT interp_member(script_ctx_t *ctx)
 static HRESULT interp_memberid(script_ctx_t *ctx)
 {
     const unsigned arg = get_op_uint(ctx, 0);
+    prop_cache_t *cache = get_op_cache(ctx, 1);
+    jsstr_t *name_str = NULL;
     jsval_t objv, namev;
     const WCHAR *name;
-    jsstr_t *name_str;
     IDispatch *obj;
+    WCHAR buf[12];
     exprval_t ref;
     DISPID id;
     HRESULT hres;
@@ -1126,7 +1186,7 @@ static HRESULT interp_memberid(script_ctx_t *ctx)
 
     hres = to_object(ctx, objv, &obj);
     jsval_release(objv);
-    if(SUCCEEDED(hres)) {
+    if(SUCCEEDED(hres) && !(name = index_name(namev, buf))) {
         hres = to_flat_string(ctx, namev, &name_str, &name);
         if(FAILED(hres))
             IDispatch_Release(obj);
@@ -1135,8 +1195,9 @@ static HRESULT interp_memberid(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, name, NULL, arg, &id);
-    jsstr_release(name_str);
+    hres = disp_get_id_cached(ctx, obj, name, NULL, arg, cache, &id);
+    if(name_str)
+        jsstr_release(name_str);
     if(SUCCEEDED(hres)) {
         ref.type = EXPRVAL_IDREF;
         ref.u.idref.disp = obj;
@@ -1285,13 +1346,13 @@ static HRESULT interp_identifier_ref(script_ctx_t *ctx, BSTR identifier, unsigne
     return stack_push_exprval(ctx, &exprval);
 }
 
-static HRESULT identifier_value(script_ctx_t *ctx, BSTR identifier)
+static HRESULT identifier_value(script_ctx_t *ctx, BSTR identifier, prop_cache_t *cache)
 {
     exprval_t exprval;
     jsval_t v;
     HRESULT hres;
 
-    hres = identifier_eval(ctx, identifier, &exprval);
+    hres = identifier_eval_cached(ctx, identifier, cache, &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -1332,7 +1393,7 @@ static HRESULT interp_local(script_ctx_t *ctx)
     TRACE("%d: %s\n", arg, debugstr_w(local_name(frame, arg)));
 
     if(!frame->base_scope || !frame->base_scope->frame)
-        return identifier_value(ctx, local_name(frame, arg));
+        return identifier_value(ctx, local_name(frame, arg), NULL);
 
     hres = jsval_copy(ctx->stack[local_off(frame, arg)], &copy);
     if(FAILED(hres))
@@ -1345,10 +1406,11 @@ static HRESULT interp_local(script_ctx_t *ctx)
 static HRESULT interp_ident(script_ctx_t *ctx)
 {
     const BSTR arg = get_op_bstr(ctx, 0);
+    prop_cache_t *cache = get_op_cache(ctx, 1);
 
     TRACE("%s\n", debugstr_w(arg));
 
-    return identifier_value(ctx, arg);
+    return identifier_value(ctx, arg, cache);
 }
 
 /* ECMA-262 3rd Edition    10.1.4 */
@@ -2086,15 +2148,12 @@ static HRESULT interp_tonum(script_ctx_t *ctx)
 }
 
 /* ECMA-262 3rd Edition    11.3.1 */
-static HRESULT interp_postinc(script_ctx_t *ctx)
+static HRESULT postinc(script_ctx_t *ctx, int arg)
 {
-    const int arg = get_op_int(ctx, 0);
     exprval_t ref;
     jsval_t v;
     HRESULT hres;
 
-    TRACE("%d\n", arg);
-
     if(!stack_pop_exprval(ctx, &ref))
         return JS_E_OBJECT_EXPECTED;
 
@@ -2115,17 +2174,77 @@ static HRESULT interp_postinc(script_ctx_t *ctx)
     return stack_push(ctx, v);
 }
 
-/* ECMA-262 3rd Edition    11.4.4, 11.4.5 */
-static HRESULT interp_preinc(script_ctx_t *ctx)
+static HRESULT interp_postinc(script_ctx_t *ctx)
+{
+    const int arg = get_op_int(ctx, 0);
+
+    TRACE("%d\n", arg);
+
+    return postinc(ctx, arg);
+}
+
+/* Increments local variable in place, without going through exprval. */
+static HRESULT local_inc(script_ctx_t *ctx, int ref, int n, jsval_t *old, double *ret)
+{
+    call_frame_t *frame = ctx->call_ctx;
+    jsval_t *var;
+    jsval_t v;
+    HRESULT hres;
+
+    hres = jsval_copy(ctx->stack[local_off(frame, ref)], &v);
+    if(FAILED(hres))
+        return hres;
+
+    hres = to_number(ctx, v, ret);
+    if(FAILED(hres)) {
+        jsval_release(v);
+        return hres;
+    }
+
+    *ret += (double)n;
+    var = ctx->stack + local_off(frame, ref);
+    jsval_release(*var);
+    *var = jsval_number(*ret);
+
+    if(old)
+        *old = v;
+    else
+        jsval_release(v);
+    return S_OK;
+}
+
+static HRESULT interp_postinc_local(script_ctx_t *ctx)
 {
     const int arg = get_op_int(ctx, 0);
+    const int n = get_op_int(ctx, 1);
+    call_frame_t *frame = ctx->call_ctx;
+    jsval_t v;
+    double ret;
+    HRESULT hres;
+
+    TRACE("%d %d\n", arg, n);
+
+    if(!frame->base_scope || !frame->base_scope->frame) {
+        hres = interp_identifier_ref(ctx, local_name(frame, arg), fdexNameEnsure);
+        if(FAILED(hres))
+            return hres;
+        return postinc(ctx, n);
+    }
+
+    hres = local_inc(ctx, arg, n, &v, &ret);
+    if(FAILED(hres))
+        return hres;
+
+    return stack_push(ctx, v);
+}
+
+static HRESULT preinc(script_ctx_t *ctx, int arg)
+{
     exprval_t ref;
     double ret;
     jsval_t v;
     HRESULT hres;
 
-    TRACE("%d\n", arg);
-
     if(!stack_pop_exprval(ctx, &ref))
         return JS_E_OBJECT_EXPECTED;
 
@@ -2147,6 +2266,40 @@ static HRESULT interp_preinc(script_ctx_t *ctx)
     return stack_push(ctx, jsval_number(ret));
 }
 
+/* ECMA-262 3rd Edition    11.4.4, 11.4.5 */
+static HRESULT interp_preinc(script_ctx_t *ctx)
+{
+    const int arg = get_op_int(ctx, 0);
+
+    TRACE("%d\n", arg);
+
+    return preinc(ctx, arg);
+}
+
+static HRESULT interp_preinc_local(script_ctx_t *ctx)
+{
+    const int arg = get_op_int(ctx, 0);
+    const int n = get_op_int(ctx, 1);
+    call_frame_t *frame = ctx->call_ctx;
+    double ret;
+    HRESULT hres;
+
+    TRACE("%d %d\n", arg, n);
+
+    if(!frame->base_scope || !frame->base_scope->frame) {
+        hres = interp_identifier_ref(ctx, local_name(frame, arg), fdexNameEnsure);
+        if(FAILED(hres))
+            return hres;
+        return preinc(ctx, n);
+    }
+
+    hres = local_inc(ctx, arg, n, NULL, &ret);
+    if(FAILED(hres))
+        return hres;
+
+    return stack_push(ctx, jsval_number(ret));
+}
+
 /* ECMA-262 3rd Edition    11.9.3 */
 static HRESULT equal_values(script_ctx_t *ctx, jsval_t lval, jsval_t rval, BOOL *ret)
 {
@@ -2607,6 +2760,67 @@ static HRESULT interp_jmp_z(script_ctx_t *ctx)
     return S_OK;
 }
 
+/* Relational operator fused with the following jmp_z, used for loop and if conditions. */
+static HRESULT interp_cmp_jmp_z(script_ctx_t *ctx)
+{
+    const unsigned addr = get_op_uint(ctx, 0);
+    const jsop_t op = get_op_uint(ctx, 1);
+    jsval_t l, r;
+    BOOL b;
+    HRESULT hres;
+
+    r = stack_pop(ctx);
+    l = stack_pop(ctx);
+
+    TRACE("%d %s %s\n", op, debugstr_jsval(l), debugstr_jsval(r));
+
+    if(is_number(l) && is_number(r)) {
+        double ln = get_number(l), rn = get_number(r);
+
+        switch(op) {
+        case OP_lt:
+            b = ln < rn;
+            break;
+        case OP_lteq:
+            b = ln <= rn;
+            break;
+        case OP_gt:
+            b = ln > rn;
+            break;
+        case OP_gteq:
+            b = ln >= rn;
+            break;
+        DEFAULT_UNREACHABLE;
+        }
+    }else {
+        switch(op) {
+        case OP_lt:
+            hres = less_eval(ctx, l, r, FALSE, &b);
+            break;
+        case OP_lteq:
+            hres = less_eval(ctx, r, l, TRUE, &b);
+            break;
+        case OP_gt:
+            hres = less_eval(ctx, r, l, FALSE, &b);
+            break;
+        case OP_gteq:
+            hres = less_eval(ctx, l, r, TRUE, &b);
+            break;
+        DEFAULT_UNREACHABLE;
+        }
+        jsval_release(l);
+        jsval_release(r);
+        if(FAILED(hres))
+            return hres;
+    }
+
+    if(b)
+        jmp_next(ctx);
+    else
+        jmp_abs(ctx, addr);
+    return S_OK;
+}
+
 static HRESULT interp_pop(script_ctx_t *ctx)
 {
     const unsigned arg = get_op_uint(ctx, 0);
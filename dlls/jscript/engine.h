@@ -29,6 +29,7 @@
     X(carray,     1, ARG_UINT,   0)        \
     X(carray_set, 1, ARG_UINT,   0)        \
     X(case,       0, ARG_ADDR,   0)        \
+    X(cmp_jmp_z,  0, ARG_ADDR,   ARG_UINT) \
     X(cnd_nz,     0, ARG_ADDR,   0)        \
     X(cnd_z,      0, ARG_ADDR,   0)        \
     X(delete,     1, 0,0)                  \
@@ -43,7 +44,7 @@
     X(func,       1, ARG_UINT,   0)        \
     X(gt,         1, 0,0)                  \
     X(gteq,       1, 0,0)                  \
-    X(ident,      1, ARG_BSTR,   0)        \
+    X(ident,      1, ARG_BSTR,   ARG_CACHE) \
     X(identid,    1, ARG_BSTR,   ARG_INT)  \
     X(in,         1, 0,0)                  \
     X(instanceof, 1, 0,0)                  \
@@ -55,8 +56,8 @@
     X(lshift,     1, 0,0)                  \
     X(lt,         1, 0,0)                  \
     X(lteq,       1, 0,0)                  \
-    X(member,     1, ARG_BSTR,   0)        \
-    X(memberid,   1, ARG_UINT,   0)        \
+    X(member,     1, ARG_BSTR,   ARG_CACHE) \
+    X(memberid,   1, ARG_UINT,   ARG_CACHE) \
     X(minus,      1, 0,0)                  \
     X(mod,        1, 0,0)                  \
     X(mul,        1, 0,0)                  \
@@ -72,7 +73,9 @@
     X(pop_except, 0, ARG_ADDR,   0)        \
     X(pop_scope,  1, 0,0)                  \
     X(postinc,    1, ARG_INT,    0)        \
+    X(postinc_local,1,ARG_INT,   ARG_INT)  \
     X(preinc,     1, ARG_INT,    0)        \
+    X(preinc_local,1,ARG_INT,    ARG_INT)  \
     X(push_acc,   1, 0,0)                  \
     X(push_except,1, ARG_ADDR,   ARG_UINT) \
     X(push_scope, 1, 0,0)                  \
@@ -110,12 +113,14 @@ typedef union {
     LONG lng;
     jsstr_t *str;
     unsigned uint;
+    prop_cache_t *cache;
 } instr_arg_t;
 
 typedef enum {
     ARG_NONE = 0,
     ARG_ADDR,
     ARG_BSTR,
+    ARG_CACHE,
     ARG_DBL,
     ARG_FUNC,
     ARG_INT,
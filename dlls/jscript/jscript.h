@@ -87,6 +87,14 @@ static inline LPWSTR heap_strdupW(LPCWSTR str)
 
 typedef struct jsdisp_t jsdisp_t;
 
+/* Per bytecode site cache of the last property lookup. The object is not referenced,
+ * it's only compared against and the cached DISPID is validated before use. */
+typedef struct {
+    jsdisp_t *obj;
+    DISPID id;
+    unsigned hash;
+} prop_cache_t;
+
 extern HINSTANCE jscript_hinstance DECLSPEC_HIDDEN;
 HRESULT get_dispatch_typeinfo(ITypeInfo**) DECLSPEC_HIDDEN;
 
@@ -307,6 +315,8 @@ HRESULT jsdisp_propput_idx(jsdisp_t*,DWORD,jsval_t) DECLSPEC_HIDDEN;
 HRESULT jsdisp_propget_name(jsdisp_t*,LPCWSTR,jsval_t*) DECLSPEC_HIDDEN;
 HRESULT jsdisp_get_idx(jsdisp_t*,DWORD,jsval_t*) DECLSPEC_HIDDEN;
 HRESULT jsdisp_get_id(jsdisp_t*,const WCHAR*,DWORD,DISPID*) DECLSPEC_HIDDEN;
+HRESULT jsdisp_get_id_cached(jsdisp_t*,const WCHAR*,DWORD,prop_cache_t*,DISPID*) DECLSPEC_HIDDEN;
+void init_prop_cache(prop_cache_t*,const WCHAR*) DECLSPEC_HIDDEN;
 HRESULT disp_delete(IDispatch*,DISPID,BOOL*) DECLSPEC_HIDDEN;
 HRESULT disp_delete_name(script_ctx_t*,IDispatch*,jsstr_t*,BOOL*) DECLSPEC_HIDDEN;
 HRESULT jsdisp_delete_idx(jsdisp_t*,DWORD) DECLSPEC_HIDDEN;
@@ -429,6 +439,11 @@ struct _script_ctx_t {
     unsigned stack_top;
     jsval_t acc;
 
+    jsdisp_t **free_queue;
+    unsigned free_queue_size;
+    unsigned free_queue_len;
+    BOOL freeing_objects;
+
     jsstr_t *last_match;
     match_result_t match_parens[9];
     DWORD last_match_index;
@@ -1910,6 +1910,104 @@ ok(Object === 1, "Object = " + Object);
 Array = 1;
 ok(Array === 1, "Array = " + Array);
 
+function testPropCache() {
+    function getX(o) { return o.x; }
+    function setX(o, v) { o.x = v; }
+    var o1 = {x: 1}, o2 = {y: 0, x: 2}, proto = {x: 3}, i, r;
+
+    ok(getX(o1) === 1, "getX(o1) = " + getX(o1));
+    ok(getX(o2) === 2, "getX(o2) = " + getX(o2));
+    ok(getX(o1) === 1, "getX(o1) = " + getX(o1));
+    delete o1.x;
+    ok(getX(o1) === undefined, "getX(o1) = " + getX(o1));
+    setX(o1, 4);
+    ok(getX(o1) === 4, "getX(o1) = " + getX(o1));
+
+    function C() {}
+    C.prototype = proto;
+    r = new C();
+    ok(getX(r) === 3, "getX(r) = " + getX(r));
+    setX(r, 5);
+    ok(getX(r) === 5, "getX(r) = " + getX(r));
+    ok(proto.x === 3, "proto.x = " + proto.x);
+    delete r.x;
+    ok(getX(r) === 3, "getX(r) = " + getX(r));
+
+    r = [];
+    for(i = 0; i < 20; i++)
+        r[i] = i;
+    r[10000000000] = "big";
+    r[-1] = "neg";
+    r[1.5] = "frac";
+    for(i = 0; i < 20; i++)
+        ok(r[i] === i, "r[" + i + "] = " + r[i]);
+    ok(r["10000000000"] === "big", "r[10000000000] = " + r["10000000000"]);
+    ok(r["-1"] === "neg", "r[-1] = " + r["-1"]);
+    ok(r["1.5"] === "frac", "r[1.5] = " + r["1.5"]);
+}
+testPropCache();
+
+function testLocalLoops() {
+    var i, j, n = 0, s = "3", x;
+
+    for(i = 0; i < 10; i++)
+        n++;
+    ok(i === 10, "i = " + i);
+    ok(n === 10, "n = " + n);
+
+    for(i = 10; i >= 0; --i)
+        n--;
+    ok(i === -1, "i = " + i);
+    ok(n === -1, "n = " + n);
+
+    x = s++;
+    ok(x == 3, "x = " + x);
+    ok(s === 4, "s = " + s);
+    s = "a";
+    x = ++s;
+    ok(isNaN(x), "x = " + x);
+    ok(isNaN(s), "s = " + s);
+
+    j = 0;
+    for(i = "0"; i < "5"; i++)
+        j++;
+    ok(j === 5, "j = " + j);
+
+    j = 0;
+    while(j <= NaN)
+        j++;
+    ok(j === 0, "j = " + j);
+    if(NaN >= 0)
+        ok(false, "NaN >= 0");
+    if(1 > undefined)
+        ok(false, "1 > undefined");
+    if("b" > "a")
+        j = 1;
+    ok(j === 1, "j = " + j);
+
+    i = 0;
+    do {
+        j++;
+    }while(++i < 3);
+    ok(i === 3, "i = " + i);
+    ok(j === 4, "j = " + j);
+}
+testLocalLoops();
+
+function testLongChainRelease() {
+    var head = null, i;
+
+    for(i = 0; i < 100000; i++)
+        head = {next: head, arr: [head]};
+    ok(head.next.arr[0] === head.next.next, "unexpected chain");
+    head = null;
+
+    for(i = 0; i < 100000; i++)
+        head = [head];
+    head = null;
+}
+testLongChainRelease();
+
 Date = 1;
 ok(Date === 1, "Date = " + Date);
 
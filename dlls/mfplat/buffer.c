@@ -22,11 +22,126 @@
 #include "rtworkq.h"
 
 #include "wine/debug.h"
+#include "wine/list.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(mfplat);
 
 #define ALIGN_SIZE(size, alignment) (((size) + (alignment)) & ~((alignment)))
 
+/* Released buffer memory is kept around for reuse, so that pipelines that keep
+   allocating same-sized frames don't go through the heap every time. Small blocks
+   are cheap to allocate and are not cached. */
+#define BUFFER_CACHE_MIN_BLOCK_SIZE 0x8000
+#define BUFFER_CACHE_MAX_BLOCKS 16
+#define BUFFER_CACHE_MAX_SIZE (64 * 1024 * 1024)
+
+struct buffer_cache_block
+{
+    struct list entry;
+    SIZE_T size;
+};
+
+static struct
+{
+    struct list blocks;
+    unsigned int count;
+    SIZE_T size;
+}
+buffer_cache = { LIST_INIT(buffer_cache.blocks) };
+
+static CRITICAL_SECTION buffer_cache_cs;
+static CRITICAL_SECTION_DEBUG buffer_cache_cs_debug =
+{
+    0, 0, &buffer_cache_cs,
+    { &buffer_cache_cs_debug.ProcessLocksList, &buffer_cache_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": buffer_cache_cs") }
+};
+static CRITICAL_SECTION buffer_cache_cs = { &buffer_cache_cs_debug, -1, 0, 0, 0, 0 };
+
+static void *buffer_memory_alloc(SIZE_T size, BOOL zero)
+{
+    struct buffer_cache_block *block = NULL, *cur;
+
+    if (size >= BUFFER_CACHE_MIN_BLOCK_SIZE)
+    {
+        EnterCriticalSection(&buffer_cache_cs);
+        LIST_FOR_EACH_ENTRY(cur, &buffer_cache.blocks, struct buffer_cache_block, entry)
+        {
+            if (cur->size == size)
+            {
+                list_remove(&cur->entry);
+                buffer_cache.count--;
+                buffer_cache.size -= size;
+                block = cur;
+                break;
+            }
+        }
+        LeaveCriticalSection(&buffer_cache_cs);
+    }
+
+    if (!block)
+        return zero ? heap_alloc_zero(size) : heap_alloc(size);
+
+    if (zero)
+        memset(block, 0, size);
+
+    return block;
+}
+
+static void buffer_memory_free(void *memory, SIZE_T size)
+{
+    struct buffer_cache_block *block = memory, *evicted[BUFFER_CACHE_MAX_BLOCKS];
+    unsigned int i, evicted_count = 0;
+    struct list *tail;
+
+    if (!memory)
+        return;
+
+    if (size < BUFFER_CACHE_MIN_BLOCK_SIZE || size > BUFFER_CACHE_MAX_SIZE)
+    {
+        heap_free(memory);
+        return;
+    }
+
+    block->size = size;
+
+    EnterCriticalSection(&buffer_cache_cs);
+
+    /* Most recently released blocks go first, least recently used ones are evicted. */
+    list_add_head(&buffer_cache.blocks, &block->entry);
+    buffer_cache.count++;
+    buffer_cache.size += size;
+
+    while (buffer_cache.count > BUFFER_CACHE_MAX_BLOCKS || buffer_cache.size > BUFFER_CACHE_MAX_SIZE)
+    {
+        tail = list_tail(&buffer_cache.blocks);
+        evicted[evicted_count] = LIST_ENTRY(tail, struct buffer_cache_block, entry);
+        list_remove(tail);
+        buffer_cache.count--;
+        buffer_cache.size -= evicted[evicted_count++]->size;
+    }
+
+    LeaveCriticalSection(&buffer_cache_cs);
+
+    for (i = 0; i < evicted_count; ++i)
+        heap_free(evicted[i]);
+}
+
+void release_buffer_cache(void)
+{
+    struct buffer_cache_block *block, *next;
+    struct list blocks = LIST_INIT(blocks);
+
+    EnterCriticalSection(&buffer_cache_cs);
+    list_move_tail(&blocks, &buffer_cache.blocks);
+    buffer_cache.count = 0;
+    buffer_cache.size = 0;
+    LeaveCriticalSection(&buffer_cache_cs);
+
+    LIST_FOR_EACH_ENTRY_SAFE(block, next, &blocks, struct buffer_cache_block, entry)
+        heap_free(block);
+}
+
 struct memory_buffer
 {
     IMFMediaBuffer IMFMediaBuffer_iface;
@@ -34,12 +149,15 @@ struct memory_buffer
     LONG refcount;
 
     BYTE *data;
+    void *memory;
+    SIZE_T memory_size;
     DWORD max_length;
     DWORD current_length;
 
     struct
     {
         BYTE *linear_buffer;
+        SIZE_T linear_buffer_size;
         unsigned int plane_size;
 
         BYTE *scanline0;
@@ -137,8 +255,8 @@ static ULONG WINAPI memory_buffer_Release(IMFMediaBuffer *iface)
     if (!refcount)
     {
         DeleteCriticalSection(&buffer->cs);
-        heap_free(buffer->_2d.linear_buffer);
-        heap_free(buffer->data);
+        buffer_memory_free(buffer->_2d.linear_buffer, buffer->_2d.linear_buffer_size);
+        buffer_memory_free(buffer->memory, buffer->memory_size);
         heap_free(buffer);
     }
 
@@ -270,7 +388,8 @@ static HRESULT WINAPI memory_1d_2d_buffer_Lock(IMFMediaBuffer *iface, BYTE **dat
         hr = MF_E_INVALIDREQUEST;
     else if (!buffer->_2d.linear_buffer)
     {
-        if (!(buffer->_2d.linear_buffer = heap_alloc(ALIGN_SIZE(buffer->_2d.plane_size, MF_64_BYTE_ALIGNMENT))))
+        buffer->_2d.linear_buffer_size = ALIGN_SIZE(buffer->_2d.plane_size, MF_64_BYTE_ALIGNMENT);
+        if (!(buffer->_2d.linear_buffer = buffer_memory_alloc(buffer->_2d.linear_buffer_size, FALSE)))
             hr = E_OUTOFMEMORY;
     }
 
@@ -302,7 +421,7 @@ static HRESULT WINAPI memory_1d_2d_buffer_Unlock(IMFMediaBuffer *iface)
         MFCopyImage(buffer->data, buffer->_2d.pitch, buffer->_2d.linear_buffer, buffer->_2d.width,
                 buffer->_2d.width, buffer->_2d.height);
 
-        heap_free(buffer->_2d.linear_buffer);
+        buffer_memory_free(buffer->_2d.linear_buffer, buffer->_2d.linear_buffer_size);
         buffer->_2d.linear_buffer = NULL;
     }
 
@@ -514,9 +633,11 @@ static const IMF2DBuffer2Vtbl memory_2d_buffer_vtbl =
 static HRESULT memory_buffer_init(struct memory_buffer *buffer, DWORD max_length, DWORD alignment,
         const IMFMediaBufferVtbl *vtbl)
 {
-    buffer->data = heap_alloc_zero(ALIGN_SIZE(max_length, alignment));
-    if (!buffer->data)
+    /* Overallocate so that the data pointer itself honours requested alignment. */
+    buffer->memory_size = ALIGN_SIZE(max_length, alignment) + alignment;
+    if (!(buffer->memory = buffer_memory_alloc(buffer->memory_size, TRUE)))
         return E_OUTOFMEMORY;
+    buffer->data = (BYTE *)(((ULONG_PTR)buffer->memory + alignment) & ~(ULONG_PTR)alignment);
 
     buffer->IMFMediaBuffer_iface.lpVtbl = vtbl;
     buffer->refcount = 1;
@@ -791,7 +912,10 @@ static ULONG WINAPI sample_tracked_Release(IMFSample *iface)
     refcount = InterlockedDecrement(&sample->attributes.ref);
     if (sample->tracked_result && sample->tracked_refcount == refcount)
     {
-        /* Call could fail if queue system is not initialized, it's not critical. */
+        /* The sample is handed back to its allocator together with its buffers, which the
+           allocator reuses as is. Buffer memory is returned to the buffer cache only once
+           the buffers themselves are released, same as for regular samples.
+           Call could fail if queue system is not initialized, it's not critical. */
         if (FAILED(hr = RtwqInvokeCallback(sample->tracked_result)))
             WARN("Failed to invoke tracking callback, hr %#x.\n", hr);
         IRtwqAsyncResult_Release(sample->tracked_result);
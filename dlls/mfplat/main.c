@@ -1500,6 +1500,7 @@ HRESULT WINAPI MFShutdown(void)
     TRACE("\n");
 
     RtwqShutdown();
+    release_buffer_cache();
 
     return S_OK;
 }
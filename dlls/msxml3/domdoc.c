@@ -75,6 +75,25 @@ static const WCHAR PropertyAllowXsltScriptW[] = {'A','l','l','o','w','X','s','l'
 static const WCHAR PropertyAllowDocumentFunctionW[] = {'A','l','l','o','w','D','o','c','u','m','e','n','t','F','u','n','c','t','i','o','n',0};
 static const WCHAR PropertyNormalizeAttributeValuesW[] = {'N','o','r','m','a','l','i','z','e','A','t','t','r','i','b','u','t','e','V','a','l','u','e','s',0};
 
+/* Number of compiled selection queries kept per document */
+#define QUERY_CACHE_SIZE 16
+
+typedef struct {
+    xmlChar *query;
+    BOOL XPath;
+    xmlXPathCompExprPtr expr;
+} query_cache_entry;
+
+/* Free-threaded documents can be queried from several threads at once */
+static CRITICAL_SECTION query_cache_cs;
+static CRITICAL_SECTION_DEBUG query_cache_cs_dbg =
+{
+    0, 0, &query_cache_cs,
+    { &query_cache_cs_dbg.ProcessLocksList, &query_cache_cs_dbg.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": query_cache") }
+};
+static CRITICAL_SECTION query_cache_cs = { &query_cache_cs_dbg, -1, 0, 0, 0, 0 };
+
 /* Anything that passes the test_get_ownerDocument()
  * tests can go here (data shared between all instances).
  * We need to preserve this when reloading a document,
@@ -88,6 +107,8 @@ typedef struct {
     LONG selectNsStr_len;
     BOOL XPath;
     IUri *uri;
+    query_cache_entry query_cache[QUERY_CACHE_SIZE];
+    unsigned int query_cache_next;
 } domdoc_properties;
 
 typedef struct ConnectionPoint ConnectionPoint;
@@ -261,6 +282,99 @@ int registerNamespaces(xmlXPathContextPtr ctxt)
     return n;
 }
 
+static void clear_query_cache(domdoc_properties *properties)
+{
+    unsigned int i;
+
+    EnterCriticalSection(&query_cache_cs);
+    for (i = 0; i < QUERY_CACHE_SIZE; i++)
+    {
+        query_cache_entry *entry = &properties->query_cache[i];
+
+        if (!entry->expr) continue;
+        xmlXPathFreeCompExpr(entry->expr);
+        xmlFree(entry->query);
+        entry->expr = NULL;
+        entry->query = NULL;
+    }
+    properties->query_cache_next = 0;
+    LeaveCriticalSection(&query_cache_cs);
+}
+
+/* Removes compiled form of a selection query for current selection language from the cache,
+   caller owns returned expression and gives it back with xmldoc_add_query() once evaluated.
+   Expressions in use are never in the cache, so other threads can't free them. */
+xmlXPathCompExprPtr xmldoc_take_query(xmlDocPtr doc, xmlChar const *query)
+{
+    domdoc_properties *properties = properties_from_xmlDocPtr(doc);
+    xmlXPathCompExprPtr expr = NULL;
+    unsigned int i;
+
+    EnterCriticalSection(&query_cache_cs);
+    for (i = 0; i < QUERY_CACHE_SIZE; i++)
+    {
+        query_cache_entry *entry = &properties->query_cache[i];
+
+        if (entry->expr && entry->XPath == properties->XPath && xmlStrEqual(entry->query, query))
+        {
+            expr = entry->expr;
+            xmlFree(entry->query);
+            entry->expr = NULL;
+            entry->query = NULL;
+            break;
+        }
+    }
+    LeaveCriticalSection(&query_cache_cs);
+
+    return expr;
+}
+
+/* Takes ownership of compiled expression on success. Free slot is used if there is one,
+   otherwise oldest entry is evicted. Fails if same query was cached in the meantime. */
+BOOL xmldoc_add_query(xmlDocPtr doc, xmlChar const *query, xmlXPathCompExprPtr expr)
+{
+    domdoc_properties *properties = properties_from_xmlDocPtr(doc);
+    query_cache_entry *entry = NULL;
+    xmlChar *str;
+    unsigned int i;
+
+    if (!(str = xmlStrdup(query)))
+        return FALSE;
+
+    EnterCriticalSection(&query_cache_cs);
+
+    for (i = 0; i < QUERY_CACHE_SIZE; i++)
+    {
+        query_cache_entry *cur = &properties->query_cache[i];
+
+        if (!cur->expr)
+        {
+            if (!entry) entry = cur;
+        }
+        else if (cur->XPath == properties->XPath && xmlStrEqual(cur->query, query))
+        {
+            LeaveCriticalSection(&query_cache_cs);
+            xmlFree(str);
+            return FALSE;
+        }
+    }
+
+    if (!entry)
+    {
+        entry = &properties->query_cache[properties->query_cache_next];
+        properties->query_cache_next = (properties->query_cache_next + 1) % QUERY_CACHE_SIZE;
+        xmlXPathFreeCompExpr(entry->expr);
+        xmlFree(entry->query);
+    }
+
+    entry->query = str;
+    entry->XPath = properties->XPath;
+    entry->expr = expr;
+
+    LeaveCriticalSection(&query_cache_cs);
+    return TRUE;
+}
+
 static inline void clear_selectNsList(struct list* pNsList)
 {
     select_ns_entry *ns, *ns2;
@@ -295,6 +409,8 @@ static domdoc_properties *create_properties(MSXML_VERSION version)
     properties->schemaCache = NULL;
     properties->selectNsStr = heap_alloc_zero(sizeof(xmlChar));
     properties->selectNsStr_len = 0;
+    memset(properties->query_cache, 0, sizeof(properties->query_cache));
+    properties->query_cache_next = 0;
 
     /* properties that are dependent on object versions */
     properties->version = version;
@@ -323,6 +439,8 @@ static domdoc_properties* copy_properties(domdoc_properties const* properties)
             IXMLDOMSchemaCollection2_AddRef(pcopy->schemaCache);
         pcopy->XPath = properties->XPath;
         pcopy->selectNsStr_len = properties->selectNsStr_len;
+        memset(pcopy->query_cache, 0, sizeof(pcopy->query_cache));
+        pcopy->query_cache_next = 0;
         list_init( &pcopy->selectNsList );
         pcopy->selectNsStr = heap_alloc(len);
         memcpy((xmlChar*)pcopy->selectNsStr, properties->selectNsStr, len);
@@ -352,6 +470,7 @@ static void free_properties(domdoc_properties* properties)
         if (properties->schemaCache)
             IXMLDOMSchemaCollection2_Release(properties->schemaCache);
         clear_selectNsList(&properties->selectNsList);
+        clear_query_cache(properties);
         heap_free((xmlChar*)properties->selectNsStr);
         if (properties->uri)
             IUri_Release(properties->uri);
@@ -3007,6 +3126,8 @@ static HRESULT WINAPI domdoc_setProperty(
 
         pNsList = &(This->properties->selectNsList);
         clear_selectNsList(pNsList);
+        /* XSLPattern translation resolves prefixes, cached queries depend on namespaces */
+        clear_query_cache(This->properties);
         heap_free(nsStr);
         nsStr = xmlchar_from_wchar(bstr);
 
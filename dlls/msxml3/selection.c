@@ -58,6 +58,8 @@ WINE_DEFAULT_DEBUG_CHANNEL(msxml);
 
 int registerNamespaces(xmlXPathContextPtr ctxt);
 xmlChar* XSLPattern_to_XPath(xmlXPathContextPtr ctxt, xmlChar const* xslpat_str);
+xmlXPathCompExprPtr xmldoc_take_query(xmlDocPtr doc, xmlChar const *query);
+BOOL xmldoc_add_query(xmlDocPtr doc, xmlChar const *query, xmlXPathCompExprPtr expr);
 
 typedef struct
 {
@@ -769,6 +771,7 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
 {
     domselection *This = heap_alloc(sizeof(domselection));
     xmlXPathContextPtr ctxt = xmlXPathNewContext(node->doc);
+    xmlXPathCompExprPtr expr;
     HRESULT hr;
 
     TRACE("(%p, %s, %p)\n", node, debugstr_a((char const*)query), out);
@@ -793,15 +796,18 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
     ctxt->node = node;
     registerNamespaces(ctxt);
 
+    /* Compiled queries are cached by the document, so repeated selections
+       don't need to translate and compile the same pattern again. */
+    expr = xmldoc_take_query(This->node->doc, query);
+
     if (is_xpathmode(This->node->doc))
     {
         xmlXPathRegisterAllFunctions(ctxt);
-        This->result = xmlXPathEvalExpression(query, ctxt);
+        if (!expr)
+            expr = xmlXPathCtxtCompile(ctxt, query);
     }
     else
     {
-        xmlChar* pattern_query = XSLPattern_to_XPath(ctxt, query);
-
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"not", xmlXPathNotFunction);
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"boolean", xmlXPathBooleanFunction);
 
@@ -816,10 +822,18 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"OP_IGt", XSLPattern_OP_IGt);
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"OP_IGEq", XSLPattern_OP_IGEq);
 
-        This->result = xmlXPathEvalExpression(pattern_query, ctxt);
-        xmlFree(pattern_query);
+        if (!expr)
+        {
+            xmlChar* pattern_query = XSLPattern_to_XPath(ctxt, query);
+            expr = xmlXPathCtxtCompile(ctxt, pattern_query);
+            xmlFree(pattern_query);
+        }
     }
 
+    This->result = expr ? xmlXPathCompiledEval(expr, ctxt) : NULL;
+    if (expr && !xmldoc_add_query(This->node->doc, query, expr))
+        xmlXPathFreeCompExpr(expr);
+
     if (!This->result || This->result->type != XPATH_NODESET)
     {
         hr = E_FAIL;
@@ -7500,6 +7500,18 @@ static void test_XSLPattern(void)
     ok(len == 0, "expected empty list\n");
     IXMLDOMNodeList_Release(list);
 
+    /* same query again after switching back */
+    ole_check(IXMLDOMDocument2_setProperty(doc, _bstr_("SelectionNamespaces"), _variantbstr_("xmlns:foo='urn:uuid:86B2F87F-ACB6-45cd-8B77-9BDB92A01A29'")));
+
+    hr = IXMLDOMDocument2_selectNodes(doc, _bstr_("//foo:c"), &list);
+    EXPECT_HR(hr, S_OK);
+    len = 0;
+    hr = IXMLDOMNodeList_get_length(list, &len);
+    EXPECT_HR(hr, S_OK);
+    ok(len != 0, "expected filled list\n");
+    if (len)
+        expect_list_and_release(list, "E3.E3.E2.D1 E3.E4.E2.D1");
+
     IXMLDOMDocument2_Release(doc);
 
     doc = create_document(&IID_IXMLDOMDocument2);
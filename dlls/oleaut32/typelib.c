@@ -1271,6 +1271,9 @@ typedef struct tagITypeInfoImpl
     /* Implemented Interfaces  */
     TLBImplType *impltypes;
 
+    /* member name hash index, built on first use */
+    struct tlb_name_index *name_index;
+
     struct list *pcustdata_list;
     struct list custdata_list;
 } ITypeInfoImpl;
@@ -1740,6 +1743,147 @@ static inline TLBVarDesc *TLB_get_vardesc_by_name(ITypeInfoImpl *typeinfo, const
     return NULL;
 }
 
+/* Late bound clients look up member names constantly, so type infos with many members keep
+ * a case-insensitive hash index of function and variable names. Only ASCII names are indexed,
+ * for anything else lookups fall back to a linear scan. */
+#define TLB_NAME_INDEX_MIN_MEMBERS 16
+#define TLB_NAME_INDEX_EMPTY 0x7fffffff
+
+struct tlb_name_index_entry
+{
+    ULONG hash;
+    int index;  /* function index, or ~index for variables */
+};
+
+struct tlb_name_index
+{
+    unsigned int mask;
+    struct tlb_name_index_entry entries[1];
+};
+
+/* used for type infos that can't be indexed */
+static struct tlb_name_index tlb_no_name_index;
+
+static BOOL TLB_hash_ascii_name(const OLECHAR *name, ULONG *hash)
+{
+    ULONG h = 2166136261u;
+    WCHAR c;
+
+    for (; *name; ++name)
+    {
+        if ((c = *name) >= 0x80)
+            return FALSE;
+        if (c >= 'a' && c <= 'z')
+            c -= 'a' - 'A';
+        h = (h ^ c) * 16777619u;
+    }
+
+    *hash = h;
+    return TRUE;
+}
+
+static void TLB_name_index_insert(struct tlb_name_index *index, ULONG hash, int member)
+{
+    unsigned int i = hash & index->mask;
+
+    while (index->entries[i].index != TLB_NAME_INDEX_EMPTY)
+        i = (i + 1) & index->mask;
+    index->entries[i].hash = hash;
+    index->entries[i].index = member;
+}
+
+static struct tlb_name_index *TLB_create_name_index(const ITypeInfoImpl *typeinfo)
+{
+    unsigned int i, size = 1, count = typeinfo->typeattr.cFuncs + typeinfo->typeattr.cVars;
+    struct tlb_name_index *index;
+    const TLBString *name;
+    ULONG hash;
+
+    while (size < count * 2)
+        size <<= 1;
+
+    if (!(index = heap_alloc(FIELD_OFFSET(struct tlb_name_index, entries[size]))))
+        return &tlb_no_name_index;
+    index->mask = size - 1;
+    for (i = 0; i < size; ++i)
+        index->entries[i].index = TLB_NAME_INDEX_EMPTY;
+
+    /* Functions are inserted before variables and in order, probing finds the first match. */
+    for (i = 0; i < typeinfo->typeattr.cFuncs; ++i)
+    {
+        if (!(name = typeinfo->funcdescs[i].Name)) continue;
+        if (!TLB_hash_ascii_name(name->str, &hash)) goto fail;
+        TLB_name_index_insert(index, hash, i);
+    }
+
+    for (i = 0; i < typeinfo->typeattr.cVars; ++i)
+    {
+        if (!(name = typeinfo->vardescs[i].Name)) continue;
+        if (!TLB_hash_ascii_name(name->str, &hash)) goto fail;
+        TLB_name_index_insert(index, hash, ~i);
+    }
+
+    return index;
+
+fail:
+    heap_free(index);
+    return &tlb_no_name_index;
+}
+
+static void TLB_invalidate_name_index(ITypeInfoImpl *typeinfo)
+{
+    if (typeinfo->name_index != &tlb_no_name_index)
+        heap_free(typeinfo->name_index);
+    typeinfo->name_index = NULL;
+}
+
+/* Returns FALSE if the index can't be used and caller has to search members itself. */
+static BOOL TLB_lookup_member_name(ITypeInfoImpl *typeinfo, const OLECHAR *name,
+        TLBFuncDesc **func_desc, TLBVarDesc **var_desc)
+{
+    struct tlb_name_index *index;
+    const TLBString *str;
+    unsigned int i;
+    ULONG hash;
+    int member;
+
+    if (typeinfo->typeattr.cFuncs + typeinfo->typeattr.cVars < TLB_NAME_INDEX_MIN_MEMBERS)
+        return FALSE;
+
+    if (!(index = typeinfo->name_index))
+    {
+        index = TLB_create_name_index(typeinfo);
+        if (InterlockedCompareExchangePointer((void **)&typeinfo->name_index, index, NULL))
+        {
+            if (index != &tlb_no_name_index) heap_free(index);
+            index = typeinfo->name_index;
+        }
+    }
+
+    if (index == &tlb_no_name_index || !TLB_hash_ascii_name(name, &hash))
+        return FALSE;
+
+    *func_desc = NULL;
+    *var_desc = NULL;
+
+    for (i = hash & index->mask; (member = index->entries[i].index) != TLB_NAME_INDEX_EMPTY;
+            i = (i + 1) & index->mask)
+    {
+        if (index->entries[i].hash != hash) continue;
+
+        str = member >= 0 ? typeinfo->funcdescs[member].Name : typeinfo->vardescs[~member].Name;
+        if (lstrcmpiW(str->str, name)) continue;
+
+        if (member >= 0)
+            *func_desc = &typeinfo->funcdescs[member];
+        else
+            *var_desc = &typeinfo->vardescs[~member];
+        break;
+    }
+
+    return TRUE;
+}
+
 static inline TLBCustData *TLB_get_custdata_by_guid(const struct list *custdata_list, REFGUID guid)
 {
     TLBCustData *cust_data;
@@ -5652,6 +5796,7 @@ static void ITypeInfoImpl_Destroy(ITypeInfoImpl *This)
     }
 
     TLB_FreeCustData(&This->custdata_list);
+    TLB_invalidate_name_index(This);
 
     heap_free(This);
 }
@@ -5670,7 +5815,10 @@ static ULONG WINAPI ITypeInfo_fnRelease(ITypeInfo2 *iface)
         BOOL not_attached_to_typelib = This->not_attached_to_typelib;
         ITypeLib2_Release(&This->pTypeLib->ITypeLib2_iface);
         if (not_attached_to_typelib)
+        {
+            TLB_invalidate_name_index(This);
             heap_free(This);
+        }
         /* otherwise This will be freed when typelib is freed */
     }
 
@@ -6273,7 +6421,8 @@ static HRESULT WINAPI ITypeInfo_fnGetIDsOfNames( ITypeInfo2 *iface,
         LPOLESTR  *rgszNames, UINT cNames, MEMBERID  *pMemId)
 {
     ITypeInfoImpl *This = impl_from_ITypeInfo2(iface);
-    const TLBVarDesc *pVDesc;
+    TLBFuncDesc *pFDesc = NULL;
+    TLBVarDesc *pVDesc = NULL;
     HRESULT ret=S_OK;
     UINT i, fdc;
 
@@ -6284,25 +6433,35 @@ static HRESULT WINAPI ITypeInfo_fnGetIDsOfNames( ITypeInfo2 *iface,
     for (i = 0; i < cNames; i++)
         pMemId[i] = MEMBERID_NIL;
 
-    for (fdc = 0; fdc < This->typeattr.cFuncs; ++fdc) {
-        int j;
-        const TLBFuncDesc *pFDesc = &This->funcdescs[fdc];
-        if(!lstrcmpiW(*rgszNames, TLB_get_bstr(pFDesc->Name))) {
-            if(cNames) *pMemId=pFDesc->funcdesc.memid;
-            for(i=1; i < cNames; i++){
-                for(j=0; j<pFDesc->funcdesc.cParams; j++)
-                    if(!lstrcmpiW(rgszNames[i],TLB_get_bstr(pFDesc->pParamDesc[j].Name)))
-                            break;
-                if( j<pFDesc->funcdesc.cParams)
-                    pMemId[i]=j;
-                else
-                   ret=DISP_E_UNKNOWNNAME;
-            };
-            TRACE("-- 0x%08x\n", ret);
-            return ret;
+    if (!TLB_lookup_member_name(This, *rgszNames, &pFDesc, &pVDesc))
+    {
+        for (fdc = 0; fdc < This->typeattr.cFuncs; ++fdc)
+        {
+            if (!lstrcmpiW(*rgszNames, TLB_get_bstr(This->funcdescs[fdc].Name)))
+            {
+                pFDesc = &This->funcdescs[fdc];
+                break;
+            }
         }
+        if (!pFDesc)
+            pVDesc = TLB_get_vardesc_by_name(This, *rgszNames);
+    }
+
+    if (pFDesc) {
+        int j;
+        if(cNames) *pMemId=pFDesc->funcdesc.memid;
+        for(i=1; i < cNames; i++){
+            for(j=0; j<pFDesc->funcdesc.cParams; j++)
+                if(!lstrcmpiW(rgszNames[i],TLB_get_bstr(pFDesc->pParamDesc[j].Name)))
+                        break;
+            if( j<pFDesc->funcdesc.cParams)
+                pMemId[i]=j;
+            else
+               ret=DISP_E_UNKNOWNNAME;
+        };
+        TRACE("-- 0x%08x\n", ret);
+        return ret;
     }
-    pVDesc = TLB_get_vardesc_by_name(This, *rgszNames);
     if(pVDesc){
         if(cNames)
             *pMemId = pVDesc->vardesc.memid;
@@ -7943,6 +8102,7 @@ static HRESULT WINAPI ITypeInfo_fnGetRefTypeInfo(
 
         *pTypeInfoImpl = *This;
         pTypeInfoImpl->ref = 0;
+        pTypeInfoImpl->name_index = NULL;
         list_init(&pTypeInfoImpl->custdata_list);
 
         if (This->typeattr.typekind == TKIND_INTERFACE)
@@ -10882,6 +11042,7 @@ static HRESULT WINAPI ICreateTypeInfo2_fnAddFuncDesc(ICreateTypeInfo2 *iface,
     list_init(&func_desc->custdata_list);
 
     ++This->typeattr.cFuncs;
+    TLB_invalidate_name_index(This);
 
     This->needs_layout = TRUE;
 
@@ -11038,6 +11199,7 @@ static HRESULT WINAPI ICreateTypeInfo2_fnAddVarDesc(ICreateTypeInfo2 *iface,
     var_desc->vardesc = *var_desc->vardesc_create;
 
     ++This->typeattr.cVars;
+    TLB_invalidate_name_index(This);
 
     This->needs_layout = TRUE;
 
@@ -11078,6 +11240,7 @@ static HRESULT WINAPI ICreateTypeInfo2_fnSetFuncAndParamNames(ICreateTypeInfo2 *
     }
 
     func_desc->Name = TLB_append_str(&This->pTypeLib->name_list, *names);
+    TLB_invalidate_name_index(This);
 
     for (i = 1; i < numNames; ++i) {
         TLBParDesc *par_desc = func_desc->pParamDesc + i - 1;
@@ -11101,6 +11264,7 @@ static HRESULT WINAPI ICreateTypeInfo2_fnSetVarName(ICreateTypeInfo2 *iface,
         return TYPE_E_ELEMENTNOTFOUND;
 
     This->vardescs[index].Name = TLB_append_str(&This->pTypeLib->name_list, name);
+    TLB_invalidate_name_index(This);
     return S_OK;
 }
 
@@ -30,6 +30,7 @@
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(quartz);
+WINE_DECLARE_DEBUG_CHANNEL(strmbase_perf);
 
 typedef struct StdMediaSample2
 {
@@ -55,7 +56,7 @@ typedef struct BaseMemAllocator
     HRESULT (* fnBufferPrepare)(IMemAllocator *, StdMediaSample2 *, DWORD flags);
     HRESULT (* fnBufferReleased)(IMemAllocator *, StdMediaSample2 *);
     void (* fnDestroyed)(IMemAllocator *);
-    HANDLE hSemWaiting;
+    CONDITION_VARIABLE free_cv;
     BOOL bDecommitQueued;
     BOOL bCommitted;
     LONG lWaiting;
@@ -100,7 +101,7 @@ static HRESULT BaseMemAllocator_Init(HRESULT (* fnAlloc)(IMemAllocator *),
     pMemAlloc->fnDestroyed = fnDestroyed;
     pMemAlloc->bDecommitQueued = FALSE;
     pMemAlloc->bCommitted = FALSE;
-    pMemAlloc->hSemWaiting = NULL;
+    InitializeConditionVariable(&pMemAlloc->free_cv);
     pMemAlloc->lWaiting = 0;
     pMemAlloc->pCritSect = pCritSect;
 
@@ -149,7 +150,6 @@ static ULONG WINAPI BaseMemAllocator_Release(IMemAllocator * iface)
 
     if (!ref)
     {
-        CloseHandle(This->hSemWaiting);
         if (This->bCommitted)
             This->fnFree(iface);
 
@@ -234,19 +234,11 @@ static HRESULT WINAPI BaseMemAllocator_Commit(IMemAllocator * iface)
             hr = S_OK;
         else
         {
-            if (!(This->hSemWaiting = CreateSemaphoreW(NULL, This->props.cBuffers, This->props.cBuffers, NULL)))
-            {
-                ERR("Couldn't create semaphore (error was %u)\n", GetLastError());
-                hr = HRESULT_FROM_WIN32(GetLastError());
-            }
+            hr = This->fnAlloc(iface);
+            if (SUCCEEDED(hr))
+                This->bCommitted = TRUE;
             else
-            {
-                hr = This->fnAlloc(iface);
-                if (SUCCEEDED(hr))
-                    This->bCommitted = TRUE;
-                else
-                    ERR("fnAlloc failed with error 0x%x\n", hr);
-            }
+                ERR("fnAlloc failed with error 0x%x\n", hr);
         }
     }
     LeaveCriticalSection(This->pCritSect);
@@ -271,8 +263,8 @@ static HRESULT WINAPI BaseMemAllocator_Decommit(IMemAllocator * iface)
             {
                 This->bDecommitQueued = TRUE;
                 /* notify ALL waiting threads that they cannot be allocated a buffer any more */
-                ReleaseSemaphore(This->hSemWaiting, This->lWaiting, NULL);
-                
+                WakeAllConditionVariable(&This->free_cv);
+
                 hr = S_OK;
             }
             else
@@ -281,8 +273,6 @@ static HRESULT WINAPI BaseMemAllocator_Decommit(IMemAllocator * iface)
                     ERR("Waiting: %d\n", This->lWaiting);
 
                 This->bCommitted = FALSE;
-                CloseHandle(This->hSemWaiting);
-                This->hSemWaiting = NULL;
 
                 hr = This->fnFree(iface);
                 if (FAILED(hr))
@@ -298,6 +288,7 @@ static HRESULT WINAPI BaseMemAllocator_Decommit(IMemAllocator * iface)
 static HRESULT WINAPI BaseMemAllocator_GetBuffer(IMemAllocator * iface, IMediaSample ** pSample, REFERENCE_TIME *pStartTime, REFERENCE_TIME *pEndTime, DWORD dwFlags)
 {
     BaseMemAllocator *This = impl_from_IMemAllocator(iface);
+    DWORD wait_start;
     HRESULT hr = S_OK;
 
     /* NOTE: The pStartTime and pEndTime parameters are not applied to the sample. 
@@ -310,44 +301,52 @@ static HRESULT WINAPI BaseMemAllocator_GetBuffer(IMemAllocator * iface, IMediaSa
     EnterCriticalSection(This->pCritSect);
     if (!This->bCommitted || This->bDecommitQueued)
     {
+        LeaveCriticalSection(This->pCritSect);
         WARN("Not committed\n");
-        hr = VFW_E_NOT_COMMITTED;
+        return VFW_E_NOT_COMMITTED;
     }
-    else
-        ++This->lWaiting;
-    LeaveCriticalSection(This->pCritSect);
-    if (FAILED(hr))
-        return hr;
 
-    if (WaitForSingleObject(This->hSemWaiting, (dwFlags & AM_GBF_NOWAIT) ? 0 : INFINITE) != WAIT_OBJECT_0)
+    /* Wait on a condition variable rather than on a semaphore, so that the
+     * uncontended case never has to leave the process. */
+    while (list_empty(&This->free_list))
     {
-        EnterCriticalSection(This->pCritSect);
-        --This->lWaiting;
-        LeaveCriticalSection(This->pCritSect);
-        WARN("Timed out\n");
-        return VFW_E_TIMEOUT;
-    }
+        if (dwFlags & AM_GBF_NOWAIT)
+        {
+            LeaveCriticalSection(This->pCritSect);
+            WARN("Timed out\n");
+            return VFW_E_TIMEOUT;
+        }
 
-    EnterCriticalSection(This->pCritSect);
-    {
+        wait_start = GetTickCount();
+        ++This->lWaiting;
+        SleepConditionVariableCS(&This->free_cv, This->pCritSect, INFINITE);
         --This->lWaiting;
+        TRACE_(strmbase_perf)("allocator %p: waited %u ms for a free sample.\n", This, GetTickCount() - wait_start);
+
         if (!This->bCommitted)
+        {
             hr = VFW_E_NOT_COMMITTED;
+            break;
+        }
         else if (This->bDecommitQueued)
-            hr = VFW_E_TIMEOUT;
-        else
         {
-            StdMediaSample2 *ms;
-            struct list * free = list_head(&This->free_list);
-            list_remove(free);
-            list_add_head(&This->used_list, free);
-
-            ms = LIST_ENTRY(free, StdMediaSample2, listentry);
-            assert(ms->ref == 0);
-            *pSample = (IMediaSample *)&ms->IMediaSample2_iface;
-            IMediaSample_AddRef(*pSample);
+            hr = VFW_E_TIMEOUT;
+            break;
         }
     }
+
+    if (hr == S_OK)
+    {
+        StdMediaSample2 *ms;
+        struct list * free = list_head(&This->free_list);
+        list_remove(free);
+        list_add_head(&This->used_list, free);
+
+        ms = LIST_ENTRY(free, StdMediaSample2, listentry);
+        assert(ms->ref == 0);
+        *pSample = (IMediaSample *)&ms->IMediaSample2_iface;
+        IMediaSample_AddRef(*pSample);
+    }
     LeaveCriticalSection(This->pCritSect);
 
     if (hr != S_OK)
@@ -359,7 +358,6 @@ static HRESULT WINAPI BaseMemAllocator_ReleaseBuffer(IMemAllocator * iface, IMed
 {
     BaseMemAllocator *This = impl_from_IMemAllocator(iface);
     StdMediaSample2 * pStdSample = unsafe_impl_from_IMediaSample(pSample);
-    HRESULT hr = S_OK;
 
     TRACE("(%p)->(%p)\n", This, pSample);
 
@@ -387,23 +385,18 @@ static HRESULT WINAPI BaseMemAllocator_ReleaseBuffer(IMemAllocator * iface, IMed
             This->bCommitted = FALSE;
             This->bDecommitQueued = FALSE;
 
-            CloseHandle(This->hSemWaiting);
-            This->hSemWaiting = NULL;
-            
             if (FAILED(hrfree = This->fnFree(iface)))
                 ERR("fnFree failed with error 0x%x\n", hrfree);
         }
+        else if (This->lWaiting)
+        {
+            /* notify a waiting thread that there is now a free buffer */
+            WakeConditionVariable(&This->free_cv);
+        }
     }
     LeaveCriticalSection(This->pCritSect);
 
-    /* notify a waiting thread that there is now a free buffer */
-    if (This->hSemWaiting && !ReleaseSemaphore(This->hSemWaiting, 1, NULL))
-    {
-        ERR("ReleaseSemaphore failed with error %u\n", GetLastError());
-        hr = HRESULT_FROM_WIN32(GetLastError());
-    }
-
-    return hr;
+    return S_OK;
 }
 
 static const IMemAllocatorVtbl BaseMemAllocator_VTable = 
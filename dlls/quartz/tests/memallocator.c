@@ -650,6 +650,65 @@ static void test_sample_properties(void)
     IMemAllocator_Release(allocator);
 }
 
+static DWORD WINAPI get_buffer_thread(void *arg)
+{
+    IMemAllocator *allocator = arg;
+    IMediaSample *sample;
+    HRESULT hr;
+
+    hr = IMemAllocator_GetBuffer(allocator, &sample, NULL, NULL, 0);
+    if (hr == S_OK)
+        IMediaSample_Release(sample);
+    return hr;
+}
+
+static void test_wait(void)
+{
+    ALLOCATOR_PROPERTIES req_props = {1, 65536, 1, 0}, ret_props;
+    IMemAllocator *allocator = create_allocator();
+    IMediaSample *sample, *sample2;
+    HANDLE thread;
+    DWORD ret;
+    HRESULT hr;
+
+    hr = IMemAllocator_SetProperties(allocator, &req_props, &ret_props);
+    ok(hr == S_OK, "Got hr %#x.\n", hr);
+    hr = IMemAllocator_Commit(allocator);
+    ok(hr == S_OK, "Got hr %#x.\n", hr);
+
+    hr = IMemAllocator_GetBuffer(allocator, &sample, NULL, NULL, 0);
+    ok(hr == S_OK, "Got hr %#x.\n", hr);
+
+    hr = IMemAllocator_GetBuffer(allocator, &sample2, NULL, NULL, AM_GBF_NOWAIT);
+    ok(hr == VFW_E_TIMEOUT, "Got hr %#x.\n", hr);
+
+    thread = CreateThread(NULL, 0, get_buffer_thread, allocator, 0, NULL);
+    ok(WaitForSingleObject(thread, 100) == WAIT_TIMEOUT, "Expected timeout.\n");
+
+    IMediaSample_Release(sample);
+    ok(!WaitForSingleObject(thread, 1000), "Wait timed out.\n");
+    GetExitCodeThread(thread, &ret);
+    ok(ret == S_OK, "Got hr %#x.\n", ret);
+    CloseHandle(thread);
+
+    /* Decommitting with outstanding samples wakes up waiting threads. */
+    hr = IMemAllocator_GetBuffer(allocator, &sample, NULL, NULL, 0);
+    ok(hr == S_OK, "Got hr %#x.\n", hr);
+
+    thread = CreateThread(NULL, 0, get_buffer_thread, allocator, 0, NULL);
+    ok(WaitForSingleObject(thread, 100) == WAIT_TIMEOUT, "Expected timeout.\n");
+
+    hr = IMemAllocator_Decommit(allocator);
+    ok(hr == S_OK, "Got hr %#x.\n", hr);
+    ok(!WaitForSingleObject(thread, 1000), "Wait timed out.\n");
+    GetExitCodeThread(thread, &ret);
+    ok(ret == VFW_E_NOT_COMMITTED || ret == VFW_E_TIMEOUT, "Got hr %#x.\n", ret);
+    CloseHandle(thread);
+
+    IMediaSample_Release(sample);
+    IMemAllocator_Release(allocator);
+}
+
 START_TEST(memallocator)
 {
     CoInitialize(NULL);
@@ -659,6 +718,7 @@ START_TEST(memallocator)
     test_sample_time();
     test_media_time();
     test_sample_properties();
+    test_wait();
 
     CoUninitialize();
 }
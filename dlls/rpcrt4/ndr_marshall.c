@@ -131,9 +131,6 @@ static inline void align_pointer_offset_clear( unsigned char **ptr, unsigned cha
 #define NDR_TABLE_SIZE 128
 #define NDR_TABLE_MASK 127
 
-static unsigned char *WINAPI NdrBaseTypeMarshall(PMIDL_STUB_MESSAGE, unsigned char *, PFORMAT_STRING);
-static unsigned char *WINAPI NdrBaseTypeUnmarshall(PMIDL_STUB_MESSAGE, unsigned char **, PFORMAT_STRING, unsigned char);
-static void WINAPI NdrBaseTypeBufferSize(PMIDL_STUB_MESSAGE, unsigned char *, PFORMAT_STRING);
 static void WINAPI NdrBaseTypeFree(PMIDL_STUB_MESSAGE, unsigned char *, PFORMAT_STRING);
 static ULONG WINAPI NdrBaseTypeMemorySize(PMIDL_STUB_MESSAGE, PFORMAT_STRING);
 
@@ -6614,7 +6611,7 @@ static void WINAPI NdrRangeFree(PMIDL_STUB_MESSAGE pStubMsg,
 /***********************************************************************
  *           NdrBaseTypeMarshall [internal]
  */
-static unsigned char *WINAPI NdrBaseTypeMarshall(
+unsigned char *WINAPI NdrBaseTypeMarshall(
     PMIDL_STUB_MESSAGE pStubMsg,
     unsigned char *pMemory,
     PFORMAT_STRING pFormat)
@@ -6690,7 +6687,7 @@ static unsigned char *WINAPI NdrBaseTypeMarshall(
 /***********************************************************************
  *           NdrBaseTypeUnmarshall [internal]
  */
-static unsigned char *WINAPI NdrBaseTypeUnmarshall(
+unsigned char *WINAPI NdrBaseTypeUnmarshall(
     PMIDL_STUB_MESSAGE pStubMsg,
     unsigned char **ppMemory,
     PFORMAT_STRING pFormat,
@@ -6808,7 +6805,7 @@ static unsigned char *WINAPI NdrBaseTypeUnmarshall(
 /***********************************************************************
  *           NdrBaseTypeBufferSize [internal]
  */
-static void WINAPI NdrBaseTypeBufferSize(
+void WINAPI NdrBaseTypeBufferSize(
     PMIDL_STUB_MESSAGE pStubMsg,
     unsigned char *pMemory,
     PFORMAT_STRING pFormat)
@@ -58,17 +58,17 @@ static inline void call_buffer_sizer(PMIDL_STUB_MESSAGE pStubMsg, unsigned char
     PFORMAT_STRING pFormat;
     NDR_BUFFERSIZE m;
 
+    /* base types are the most common parameters, skip the dispatch table for them */
     if (param->attr.IsBasetype)
     {
-        pFormat = &param->u.type_format_char;
         if (param->attr.IsSimpleRef) pMemory = *(unsigned char **)pMemory;
-    }
-    else
-    {
-        pFormat = &pStubMsg->StubDesc->pFormatTypes[param->u.type_offset];
-        if (!param->attr.IsByValue) pMemory = *(unsigned char **)pMemory;
+        NdrBaseTypeBufferSize(pStubMsg, pMemory, &param->u.type_format_char);
+        return;
     }
 
+    pFormat = &pStubMsg->StubDesc->pFormatTypes[param->u.type_offset];
+    if (!param->attr.IsByValue) pMemory = *(unsigned char **)pMemory;
+
     m = NdrBufferSizer[pFormat[0] & NDR_TABLE_MASK];
     if (m) m(pStubMsg, pMemory, pFormat);
     else
@@ -86,15 +86,13 @@ static inline unsigned char *call_marshaller(PMIDL_STUB_MESSAGE pStubMsg, unsign
 
     if (param->attr.IsBasetype)
     {
-        pFormat = &param->u.type_format_char;
         if (param->attr.IsSimpleRef) pMemory = *(unsigned char **)pMemory;
-    }
-    else
-    {
-        pFormat = &pStubMsg->StubDesc->pFormatTypes[param->u.type_offset];
-        if (!param->attr.IsByValue) pMemory = *(unsigned char **)pMemory;
+        return NdrBaseTypeMarshall(pStubMsg, pMemory, &param->u.type_format_char);
     }
 
+    pFormat = &pStubMsg->StubDesc->pFormatTypes[param->u.type_offset];
+    if (!param->attr.IsByValue) pMemory = *(unsigned char **)pMemory;
+
     m = NdrMarshaller[pFormat[0] & NDR_TABLE_MASK];
     if (m) return m(pStubMsg, pMemory, pFormat);
     else
@@ -113,14 +111,12 @@ static inline unsigned char *call_unmarshaller(PMIDL_STUB_MESSAGE pStubMsg, unsi
 
     if (param->attr.IsBasetype)
     {
-        pFormat = &param->u.type_format_char;
         if (param->attr.IsSimpleRef) ppMemory = (unsigned char **)*ppMemory;
+        return NdrBaseTypeUnmarshall(pStubMsg, ppMemory, &param->u.type_format_char, fMustAlloc);
     }
-    else
-    {
-        pFormat = &pStubMsg->StubDesc->pFormatTypes[param->u.type_offset];
-        if (!param->attr.IsByValue) ppMemory = (unsigned char **)*ppMemory;
-    }
+
+    pFormat = &pStubMsg->StubDesc->pFormatTypes[param->u.type_offset];
+    if (!param->attr.IsByValue) ppMemory = (unsigned char **)*ppMemory;
 
     m = NdrUnmarshaller[pFormat[0] & NDR_TABLE_MASK];
     if (m) return m(pStubMsg, ppMemory, pFormat, fMustAlloc);
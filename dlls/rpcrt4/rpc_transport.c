@@ -68,6 +68,11 @@ typedef struct _RpcConnection_np
     IO_STATUS_BLOCK io_status;
     HANDLE event_cache;
     BOOL read_closed;
+    /* read-ahead buffer holding the rest of the last message read from the pipe */
+    char *read_buffer;
+    unsigned int read_pos;
+    unsigned int read_len;
+    BOOL read_more;
 } RpcConnection_np;
 
 static RpcConnection *rpcrt4_conn_np_alloc(void)
@@ -372,9 +377,8 @@ static RPC_STATUS rpcrt4_ncalrpc_handoff(RpcConnection *old_conn, RpcConnection
   return status;
 }
 
-static int rpcrt4_conn_np_read(RpcConnection *conn, void *buffer, unsigned int count)
+static int rpcrt4_conn_np_read_pipe(RpcConnection_np *connection, void *buffer, unsigned int count)
 {
-    RpcConnection_np *connection = (RpcConnection_np *) conn;
     HANDLE event;
     NTSTATUS status;
 
@@ -401,6 +405,44 @@ static int rpcrt4_conn_np_read(RpcConnection *conn, void *buffer, unsigned int c
     return status && status != STATUS_BUFFER_OVERFLOW ? -1 : connection->io_status.Information;
 }
 
+static int rpcrt4_conn_np_read(RpcConnection *conn, void *buffer, unsigned int count)
+{
+    RpcConnection_np *connection = (RpcConnection_np *) conn;
+    unsigned int copied;
+    int ret;
+
+    /* Fragments are read piecewise, header first, but pipes are in message mode, so
+     * read the whole message at once and serve the following reads from memory
+     * instead of doing a server round trip for each of them. */
+    if (connection->read_pos == connection->read_len && !connection->read_closed && count < RPC_MAX_PACKET_SIZE)
+    {
+        if (!connection->read_buffer &&
+            !(connection->read_buffer = HeapAlloc(GetProcessHeap(), 0, RPC_MAX_PACKET_SIZE)))
+            return -1;
+
+        if ((ret = rpcrt4_conn_np_read_pipe(connection, connection->read_buffer, RPC_MAX_PACKET_SIZE)) <= 0)
+            return ret;
+        connection->read_pos = 0;
+        connection->read_len = ret;
+        connection->read_more = connection->io_status.Status == STATUS_BUFFER_OVERFLOW;
+    }
+
+    /* Buffered data is still served after reading was closed, it was already received. */
+    copied = min(count, connection->read_len - connection->read_pos);
+    if (copied)
+    {
+        memcpy(buffer, connection->read_buffer + connection->read_pos, copied);
+        connection->read_pos += copied;
+    }
+    if (copied == count || (copied && !connection->read_more))
+        return copied;
+
+    /* The message didn't fit in the buffer, read the rest of it directly. */
+    if ((ret = rpcrt4_conn_np_read_pipe(connection, (char *)buffer + copied, count - copied)) < 0)
+        return copied ? copied : ret;
+    return copied + ret;
+}
+
 static int rpcrt4_conn_np_write(RpcConnection *conn, const void *buffer, unsigned int count)
 {
     RpcConnection_np *connection = (RpcConnection_np *) conn;
@@ -445,6 +487,10 @@ static int rpcrt4_conn_np_close(RpcConnection *conn)
         CloseHandle(connection->event_cache);
         connection->event_cache = 0;
     }
+    HeapFree(GetProcessHeap(), 0, connection->read_buffer);
+    connection->read_buffer = NULL;
+    connection->read_pos = connection->read_len = 0;
+    connection->read_more = FALSE;
     return 0;
 }
 
@@ -125,6 +125,8 @@ struct work_item
     IUnknown IUnknown_iface;
     LONG refcount;
     struct list entry;
+    struct list work_entry;
+    DWORD submit_time;
     IRtwqAsyncResult *result;
     IRtwqAsyncResult *reply_result;
     struct queue *queue;
@@ -158,7 +160,7 @@ struct queue_ops
 {
     HRESULT (*init)(const struct queue_desc *desc, struct queue *queue);
     BOOL (*shutdown)(struct queue *queue);
-    void (*submit)(struct queue *queue, struct work_item *item);
+    HRESULT (*submit)(struct queue *queue, struct work_item *item);
 };
 
 struct queue_desc
@@ -176,6 +178,9 @@ struct queue
     TP_CALLBACK_ENVIRON_V3 envs[ARRAY_SIZE(priorities)];
     CRITICAL_SECTION cs;
     struct list pending_items;
+    /* Data used for pool queues only. */
+    TP_WORK *work_objects[ARRAY_SIZE(priorities)];
+    struct list work_items[ARRAY_SIZE(priorities)];
     DWORD id;
     /* Data used for serial queues only. */
     PTP_SIMPLE_CALLBACK finalization_callback;
@@ -326,6 +331,7 @@ static HRESULT pool_queue_init(const struct queue_desc *desc, struct queue *queu
     {
         queue->envs[i] = env;
         queue->envs[i].CallbackPriority = priorities[i];
+        list_init(&queue->work_items[i]);
     }
     list_init(&queue->pending_items);
     InitializeCriticalSection(&queue->cs);
@@ -341,24 +347,74 @@ static HRESULT pool_queue_init(const struct queue_desc *desc, struct queue *queu
     return S_OK;
 }
 
+static void pool_queue_release_item(struct work_item *item)
+{
+    if (item->finalization_callback)
+        IUnknown_Release(&item->IUnknown_iface);
+    IUnknown_Release(&item->IUnknown_iface);
+}
+
 static BOOL pool_queue_shutdown(struct queue *queue)
 {
+    struct work_item *item, *item2;
+    unsigned int i;
+
     if (!queue->pool)
         return FALSE;
 
     CloseThreadpoolCleanupGroupMembers(queue->envs[0].CleanupGroup, TRUE, NULL);
     CloseThreadpool(queue->pool);
     queue->pool = NULL;
+    memset(queue->work_objects, 0, sizeof(queue->work_objects));
+
+    /* Drop items that were cancelled before worker had a chance to pick them up. */
+    for (i = 0; i < ARRAY_SIZE(queue->work_items); ++i)
+    {
+        LIST_FOR_EACH_ENTRY_SAFE(item, item2, &queue->work_items[i], struct work_item, work_entry)
+        {
+            list_remove(&item->work_entry);
+            pool_queue_release_item(item);
+        }
+    }
 
     return TRUE;
 }
 
+static struct work_item *pool_queue_get_next(struct queue *queue)
+{
+    struct work_item *item = NULL;
+    unsigned int i;
+
+    EnterCriticalSection(&queue->cs);
+    for (i = 0; i < ARRAY_SIZE(queue->work_items); ++i)
+    {
+        if (!list_empty(&queue->work_items[i]))
+        {
+            item = LIST_ENTRY(list_head(&queue->work_items[i]), struct work_item, work_entry);
+            list_remove(&item->work_entry);
+            break;
+        }
+    }
+    LeaveCriticalSection(&queue->cs);
+
+    return item;
+}
+
 static void CALLBACK standard_queue_worker(TP_CALLBACK_INSTANCE *instance, void *context, TP_WORK *work)
 {
-    struct work_item *item = context;
-    RTWQASYNCRESULT *result = (RTWQASYNCRESULT *)item->result;
+    PTP_SIMPLE_CALLBACK finalization_callback;
+    struct queue *queue = context;
+    RTWQASYNCRESULT *result;
+    struct work_item *item;
+
+    /* Every submission of a work object is matched by a single queued item, but items are picked
+       in priority order rather than in order of submission. */
+    if (!(item = pool_queue_get_next(queue)))
+        return;
 
-    TRACE("result object %p.\n", result);
+    result = (RTWQASYNCRESULT *)item->result;
+
+    TRACE("queue %p, result object %p, waited %u ms.\n", queue, result, GetTickCount() - item->submit_time);
 
     /* Submitting from serial queue in reply mode, use different result object acting as receipt token.
        It's submitted to user callback still, but when invoked, special serial queue callback will be used
@@ -366,13 +422,35 @@ static void CALLBACK standard_queue_worker(TP_CALLBACK_INSTANCE *instance, void
 
     IRtwqAsyncCallback_Invoke(result->pCallback, item->reply_result ? item->reply_result : item->result);
 
+    /* Finalization callback holds its own reference. */
+    finalization_callback = item->finalization_callback;
     IUnknown_Release(&item->IUnknown_iface);
+    if (finalization_callback)
+        finalization_callback(instance, item);
 }
 
-static void pool_queue_submit(struct queue *queue, struct work_item *item)
+static void pool_queue_reset_work_objects(struct queue *queue)
 {
+    unsigned int i;
+
+    /* Work objects capture callback environment on creation. Outstanding callbacks of closed
+       objects still run, new submissions will use objects created from updated environment. */
+    EnterCriticalSection(&queue->cs);
+    for (i = 0; i < ARRAY_SIZE(queue->work_objects); ++i)
+    {
+        if (queue->work_objects[i])
+        {
+            CloseThreadpoolWork(queue->work_objects[i]);
+            queue->work_objects[i] = NULL;
+        }
+    }
+    LeaveCriticalSection(&queue->cs);
+}
+
+static HRESULT pool_queue_submit(struct queue *queue, struct work_item *item)
+{
+    PTP_SIMPLE_CALLBACK finalization_callback;
     TP_CALLBACK_PRIORITY callback_priority;
-    TP_CALLBACK_ENVIRON_V3 env;
     TP_WORK *work_object;
 
     if (item->priority == 0)
@@ -382,16 +460,44 @@ static void pool_queue_submit(struct queue *queue, struct work_item *item)
     else
         callback_priority = TP_CALLBACK_PRIORITY_HIGH;
 
-    env = queue->envs[callback_priority];
-    env.FinalizationCallback = item->finalization_callback;
-    /* Worker pool callback will release one reference. Grab one more to keep object alive when
+    /* Worker will release one reference. Grab one more to keep object alive when
        we need finalization callback. */
     if (item->finalization_callback)
         IUnknown_AddRef(&item->IUnknown_iface);
-    work_object = CreateThreadpoolWork(standard_queue_worker, item, (TP_CALLBACK_ENVIRON *)&env);
-    SubmitThreadpoolWork(work_object);
+
+    if (TRACE_ON(mfplat))
+        item->submit_time = GetTickCount();
+
+    /* Items of the same priority share a work object, created on first use from the environment
+       for that priority. */
+    EnterCriticalSection(&queue->cs);
+    if (!(work_object = queue->work_objects[callback_priority]))
+    {
+        work_object = CreateThreadpoolWork(standard_queue_worker, queue,
+                (TP_CALLBACK_ENVIRON *)&queue->envs[callback_priority]);
+        queue->work_objects[callback_priority] = work_object;
+    }
+    if (work_object)
+    {
+        list_add_tail(&queue->work_items[callback_priority], &item->work_entry);
+        SubmitThreadpoolWork(work_object);
+    }
+    LeaveCriticalSection(&queue->cs);
+
+    if (!work_object)
+    {
+        WARN("Failed to create work object.\n");
+        /* Release reference meant for the worker, and let serial queue move on. */
+        finalization_callback = item->finalization_callback;
+        IUnknown_Release(&item->IUnknown_iface);
+        if (finalization_callback)
+            finalization_callback(NULL, item);
+        return E_OUTOFMEMORY;
+    }
 
     TRACE("dispatched %p.\n", item->result);
+
+    return S_OK;
 }
 
 static const struct queue_ops pool_queue_ops =
@@ -465,7 +571,7 @@ static struct work_item * serial_queue_is_ack_token(struct queue *queue, struct
     return NULL;
 }
 
-static void serial_queue_submit(struct queue *queue, struct work_item *item)
+static HRESULT serial_queue_submit(struct queue *queue, struct work_item *item)
 {
     struct work_item *head, *next_item = NULL;
     struct queue *target_queue;
@@ -515,6 +621,8 @@ static void serial_queue_submit(struct queue *queue, struct work_item *item)
     }
 
     LeaveCriticalSection(&queue->cs);
+
+    return S_OK;
 }
 
 static const struct queue_ops serial_queue_ops =
@@ -580,6 +688,7 @@ static struct work_item * alloc_work_item(struct queue *queue, LONG priority, IR
     item->refcount = 1;
     item->queue = queue;
     list_init(&item->entry);
+    list_init(&item->work_entry);
     item->priority = priority;
 
     if (SUCCEEDED(IRtwqAsyncCallback_GetParameters(async_result->pCallback, &flags, &queue_id)))
@@ -675,9 +784,7 @@ static HRESULT queue_submit_item(struct queue *queue, LONG priority, IRtwqAsyncR
     if (!(item = alloc_work_item(queue, priority, result)))
         return E_OUTOFMEMORY;
 
-    queue->ops->submit(queue, item);
-
-    return S_OK;
+    return queue->ops->submit(queue, item);
 }
 
 static HRESULT queue_put_work_item(DWORD queue_id, LONG priority, IRtwqAsyncResult *result)
@@ -1429,6 +1536,8 @@ HRESULT WINAPI RtwqSetLongRunning(DWORD queue_id, BOOL enable)
     {
         for (i = 0; i < ARRAY_SIZE(queue->envs); ++i)
             queue->envs[i].u.s.LongFunction = !!enable;
+        if (queue->ops == &pool_queue_ops)
+            pool_queue_reset_work_objects(queue);
     }
 
     unlock_user_queue(queue_id);
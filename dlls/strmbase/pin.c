@@ -22,6 +22,7 @@
 #include "strmbase_private.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(strmbase);
+WINE_DECLARE_DEBUG_CHANNEL(strmbase_perf);
 
 static const IMemInputPinVtbl MemInputPin_Vtbl;
 
@@ -1169,16 +1170,56 @@ static HRESULT WINAPI MemInputPin_GetAllocatorRequirements(IMemInputPin *iface,
     return E_NOTIMPL;
 }
 
+static void sink_update_stats(struct strmbase_sink *pin, LONGLONG start)
+{
+    LARGE_INTEGER end, freq;
+    LONGLONG time;
+
+    QueryPerformanceCounter(&end);
+    QueryPerformanceFrequency(&freq);
+
+    time = end.QuadPart - start;
+    pin->stats.total_time += time;
+    pin->stats.max_time = max(pin->stats.max_time, time);
+    if (pin->stats.last_receive)
+        pin->stats.max_interval = max(pin->stats.max_interval, start - pin->stats.last_receive);
+    pin->stats.last_receive = start;
+    ++pin->stats.count;
+
+    if (!pin->stats.report_start)
+        pin->stats.report_start = start;
+    else if (end.QuadPart - pin->stats.report_start >= freq.QuadPart * 3 / 2)
+    {
+        TRACE_(strmbase_perf)("pin %p %s:%s: %u samples, receive average %.3f ms, maximum %.3f ms, "
+                "maximum interval %.3f ms.\n", pin, debugstr_w(pin->pin.filter->name), debugstr_w(pin->pin.name),
+                pin->stats.count, pin->stats.total_time * 1000.0 / freq.QuadPart / pin->stats.count,
+                pin->stats.max_time * 1000.0 / freq.QuadPart, pin->stats.max_interval * 1000.0 / freq.QuadPart);
+
+        pin->stats.report_start = end.QuadPart;
+        pin->stats.total_time = pin->stats.max_time = pin->stats.max_interval = 0;
+        pin->stats.count = 0;
+    }
+}
+
 static HRESULT WINAPI MemInputPin_Receive(IMemInputPin *iface, IMediaSample *sample)
 {
     struct strmbase_sink *pin = impl_from_IMemInputPin(iface);
+    BOOL stats = TRACE_ON(strmbase_perf);
+    LARGE_INTEGER start;
     HRESULT hr = S_FALSE;
 
     TRACE("pin %p %s:%s, sample %p.\n", pin, debugstr_w(pin->pin.filter->name),
             debugstr_w(pin->pin.name), sample);
 
+    if (stats)
+        QueryPerformanceCounter(&start);
+
     if (pin->pFuncsTable->pfnReceive)
         hr = pin->pFuncsTable->pfnReceive(pin, sample);
+
+    if (stats)
+        sink_update_stats(pin, start.QuadPart);
+
     return hr;
 }
 
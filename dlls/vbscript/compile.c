@@ -298,6 +298,19 @@ static HRESULT push_instr_bstr_uint(compile_ctx_t *ctx, vbsop_t op, const WCHAR
     return S_OK;
 }
 
+static HRESULT push_instr_int_uint(compile_ctx_t *ctx, vbsop_t op, LONG arg1, unsigned arg2)
+{
+    unsigned instr;
+
+    instr = push_instr(ctx, op);
+    if(!instr)
+        return E_OUTOFMEMORY;
+
+    instr_ptr(ctx, instr)->arg1.lng = arg1;
+    instr_ptr(ctx, instr)->arg2.uint = arg2;
+    return S_OK;
+}
+
 static HRESULT push_instr_uint_bstr(compile_ctx_t *ctx, vbsop_t op, unsigned arg1, const WCHAR *arg2)
 {
     unsigned instr;
@@ -406,6 +419,41 @@ static expression_t *lookup_const_decls(compile_ctx_t *ctx, const WCHAR *name, B
     return NULL;
 }
 
+/*
+ * Resolves identifier to a slot of already declared local variable (slot >= 0) or
+ * an argument (~slot) of the function being compiled. Everything else, including
+ * function return value and variables used before their Dim statement, is left
+ * to lookup_identifier at run time.
+ */
+static BOOL lookup_local_slot(compile_ctx_t *ctx, const WCHAR *name, LONG *ret)
+{
+    dim_decl_t *dim_decl;
+    unsigned i;
+
+    if(ctx->func->type == FUNC_GLOBAL)
+        return FALSE;
+
+    if((ctx->func->type == FUNC_FUNCTION || ctx->func->type == FUNC_PROPGET || ctx->func->type == FUNC_DEFGET)
+       && !wcsicmp(name, ctx->func->name))
+        return FALSE;
+
+    for(dim_decl = ctx->dim_decls, i = 0; dim_decl; dim_decl = dim_decl->next, i++) {
+        if(!wcsicmp(dim_decl->name, name)) {
+            *ret = i;
+            return TRUE;
+        }
+    }
+
+    for(i = 0; i < ctx->func->arg_cnt; i++) {
+        if(!wcsicmp(ctx->func->args[i].name, name)) {
+            *ret = ~(LONG)i;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
 static HRESULT compile_args(compile_ctx_t *ctx, expression_t *args, unsigned *ret)
 {
     unsigned arg_cnt = 0;
@@ -429,6 +477,7 @@ static HRESULT compile_args(compile_ctx_t *ctx, expression_t *args, unsigned *re
 
 static HRESULT compile_member_expression(compile_ctx_t *ctx, member_expression_t *expr, unsigned arg_cnt, BOOL ret_val)
 {
+    LONG slot;
     HRESULT hres;
 
     if(ret_val && !arg_cnt) {
@@ -445,6 +494,8 @@ static HRESULT compile_member_expression(compile_ctx_t *ctx, member_expression_t
             return hres;
 
         hres = push_instr_bstr_uint(ctx, ret_val ? OP_mcall : OP_mcallv, expr->identifier, arg_cnt);
+    }else if(ret_val && lookup_local_slot(ctx, expr->identifier, &slot)) {
+        hres = push_instr_int_uint(ctx, OP_local, slot, arg_cnt);
     }else {
         hres = push_instr_bstr_uint(ctx, ret_val ? OP_icall : OP_icallv, expr->identifier, arg_cnt);
     }
@@ -800,22 +851,30 @@ static HRESULT compile_forto_statement(compile_ctx_t *ctx, forto_statement_t *st
 {
     statement_ctx_t loop_ctx = {2};
     unsigned step_instr, instr;
-    BSTR identifier;
+    BSTR identifier = NULL;
+    BOOL is_local;
+    LONG slot;
     HRESULT hres;
 
-    identifier = alloc_bstr_arg(ctx, stat->identifier);
-    if(!identifier)
-        return E_OUTOFMEMORY;
+    is_local = lookup_local_slot(ctx, stat->identifier, &slot);
+    if(!is_local) {
+        identifier = alloc_bstr_arg(ctx, stat->identifier);
+        if(!identifier)
+            return E_OUTOFMEMORY;
+    }
 
     hres = compile_expression(ctx, stat->from_expr);
     if(FAILED(hres))
         return hres;
 
     /* FIXME: Assign should happen after both expressions evaluation. */
-    instr = push_instr(ctx, OP_assign_ident);
+    instr = push_instr(ctx, is_local ? OP_assign_local : OP_assign_ident);
     if(!instr)
         return E_OUTOFMEMORY;
-    instr_ptr(ctx, instr)->arg1.bstr = identifier;
+    if(is_local)
+        instr_ptr(ctx, instr)->arg1.lng = slot;
+    else
+        instr_ptr(ctx, instr)->arg1.bstr = identifier;
     instr_ptr(ctx, instr)->arg2.uint = 0;
 
     hres = compile_expression(ctx, stat->to_expr);
@@ -842,10 +901,13 @@ static HRESULT compile_forto_statement(compile_ctx_t *ctx, forto_statement_t *st
     if(!loop_ctx.for_end_label)
         return E_OUTOFMEMORY;
 
-    step_instr = push_instr(ctx, OP_step);
+    step_instr = push_instr(ctx, is_local ? OP_step_local : OP_step);
     if(!step_instr)
         return E_OUTOFMEMORY;
-    instr_ptr(ctx, step_instr)->arg2.bstr = identifier;
+    if(is_local)
+        instr_ptr(ctx, step_instr)->arg2.lng = slot;
+    else
+        instr_ptr(ctx, step_instr)->arg2.bstr = identifier;
     instr_ptr(ctx, step_instr)->arg1.uint = loop_ctx.for_end_label;
 
     if(!emit_catch(ctx, 2))
@@ -856,10 +918,13 @@ static HRESULT compile_forto_statement(compile_ctx_t *ctx, forto_statement_t *st
         return hres;
 
     /* FIXME: Error handling can't be done compatible with native using OP_incc here. */
-    instr = push_instr(ctx, OP_incc);
+    instr = push_instr(ctx, is_local ? OP_incc_local : OP_incc);
     if(!instr)
         return E_OUTOFMEMORY;
-    instr_ptr(ctx, instr)->arg1.bstr = identifier;
+    if(is_local)
+        instr_ptr(ctx, instr)->arg1.lng = slot;
+    else
+        instr_ptr(ctx, instr)->arg1.bstr = identifier;
 
     hres = push_instr_addr(ctx, OP_jmp, step_instr);
     if(FAILED(hres))
@@ -998,6 +1063,8 @@ static HRESULT compile_assignment(compile_ctx_t *ctx, expression_t *left, expres
     call_expression_t *call_expr = NULL;
     member_expression_t *member_expr;
     unsigned args_cnt = 0;
+    BOOL is_local = FALSE;
+    LONG slot;
     vbsop_t op;
     HRESULT hres;
 
@@ -1021,6 +1088,8 @@ static HRESULT compile_assignment(compile_ctx_t *ctx, expression_t *left, expres
             return hres;
 
         op = is_set ? OP_set_member : OP_assign_member;
+    }else if((is_local = lookup_local_slot(ctx, member_expr->identifier, &slot))) {
+        op = is_set ? OP_set_local : OP_assign_local;
     }else {
         op = is_set ? OP_set_ident : OP_assign_ident;
     }
@@ -1035,7 +1104,10 @@ static HRESULT compile_assignment(compile_ctx_t *ctx, expression_t *left, expres
             return hres;
     }
 
-    hres = push_instr_bstr_uint(ctx, op, member_expr->identifier, args_cnt);
+    if(is_local)
+        hres = push_instr_int_uint(ctx, op, slot, args_cnt);
+    else
+        hres = push_instr_bstr_uint(ctx, op, member_expr->identifier, args_cnt);
     if(FAILED(hres))
         return hres;
 
@@ -236,6 +236,13 @@ static HRESULT lookup_identifier(exec_ctx_t *ctx, BSTR name, vbdisp_invoke_type_
     return S_OK;
 }
 
+/* Locals and arguments resolved at compile time, see lookup_local_slot in compile.c. */
+static inline void lookup_local(exec_ctx_t *ctx, int slot, ref_t *ref)
+{
+    ref->type = REF_VAR;
+    ref->u.v = slot >= 0 ? ctx->vars + slot : ctx->args + ~slot;
+}
+
 static HRESULT add_dynamic_var(exec_ctx_t *ctx, const WCHAR *name,
         BOOL is_const, VARIANT **out_var)
 {
@@ -615,25 +622,16 @@ static HRESULT variant_call(exec_ctx_t *ctx, VARIANT *v, unsigned arg_cnt, VARIA
     return S_OK;
 }
 
-static HRESULT do_icall(exec_ctx_t *ctx, VARIANT *res)
+static HRESULT call_ref(exec_ctx_t *ctx, const ref_t *ref, BSTR identifier, unsigned arg_cnt, VARIANT *res)
 {
-    BSTR identifier = ctx->instr->arg1.bstr;
-    const unsigned arg_cnt = ctx->instr->arg2.uint;
     DISPPARAMS dp;
-    ref_t ref;
     HRESULT hres;
 
-    TRACE("%s %u\n", debugstr_w(identifier), arg_cnt);
-
-    hres = lookup_identifier(ctx, identifier, VBDISP_CALLGET, &ref);
-    if(FAILED(hres))
-        return hres;
-
-    switch(ref.type) {
+    switch(ref->type) {
     case REF_VAR:
     case REF_CONST:
         if(arg_cnt)
-            return variant_call(ctx, ref.u.v, arg_cnt, res);
+            return variant_call(ctx, ref->u.v, arg_cnt, res);
 
         if(!res) {
             FIXME("REF_VAR no res\n");
@@ -641,17 +639,17 @@ static HRESULT do_icall(exec_ctx_t *ctx, VARIANT *res)
         }
 
         V_VT(res) = VT_BYREF|VT_VARIANT;
-        V_BYREF(res) = V_VT(ref.u.v) == (VT_VARIANT|VT_BYREF) ? V_VARIANTREF(ref.u.v) : ref.u.v;
+        V_BYREF(res) = V_VT(ref->u.v) == (VT_VARIANT|VT_BYREF) ? V_VARIANTREF(ref->u.v) : ref->u.v;
         break;
     case REF_DISP:
         vbstack_to_dp(ctx, arg_cnt, FALSE, &dp);
-        hres = disp_call(ctx->script, ref.u.d.disp, ref.u.d.id, &dp, res);
+        hres = disp_call(ctx->script, ref->u.d.disp, ref->u.d.id, &dp, res);
         if(FAILED(hres))
             return hres;
         break;
     case REF_FUNC:
         vbstack_to_dp(ctx, arg_cnt, FALSE, &dp);
-        hres = exec_script(ctx->script, FALSE, ref.u.f, NULL, &dp, res);
+        hres = exec_script(ctx->script, FALSE, ref->u.f, NULL, &dp, res);
         if(FAILED(hres))
             return hres;
         break;
@@ -662,9 +660,9 @@ static HRESULT do_icall(exec_ctx_t *ctx, VARIANT *res)
         }
 
         if(res) {
-            IDispatch_AddRef(ref.u.obj);
+            IDispatch_AddRef(ref->u.obj);
             V_VT(res) = VT_DISPATCH;
-            V_DISPATCH(res) = ref.u.obj;
+            V_DISPATCH(res) = ref->u.obj;
         }
         break;
     case REF_NONE:
@@ -685,6 +683,22 @@ static HRESULT do_icall(exec_ctx_t *ctx, VARIANT *res)
     return S_OK;
 }
 
+static HRESULT do_icall(exec_ctx_t *ctx, VARIANT *res)
+{
+    BSTR identifier = ctx->instr->arg1.bstr;
+    const unsigned arg_cnt = ctx->instr->arg2.uint;
+    ref_t ref;
+    HRESULT hres;
+
+    TRACE("%s %u\n", debugstr_w(identifier), arg_cnt);
+
+    hres = lookup_identifier(ctx, identifier, VBDISP_CALLGET, &ref);
+    if(FAILED(hres))
+        return hres;
+
+    return call_ref(ctx, &ref, identifier, arg_cnt, res);
+}
+
 static HRESULT interp_icall(exec_ctx_t *ctx)
 {
     VARIANT v;
@@ -705,6 +719,24 @@ static HRESULT interp_icallv(exec_ctx_t *ctx)
     return do_icall(ctx, NULL);
 }
 
+static HRESULT interp_local(exec_ctx_t *ctx)
+{
+    const int slot = ctx->instr->arg1.lng;
+    const unsigned arg_cnt = ctx->instr->arg2.uint;
+    VARIANT v;
+    ref_t ref;
+    HRESULT hres;
+
+    TRACE("%d %u\n", slot, arg_cnt);
+
+    lookup_local(ctx, slot, &ref);
+    hres = call_ref(ctx, &ref, NULL, arg_cnt, &v);
+    if(FAILED(hres))
+        return hres;
+
+    return stack_push(ctx, &v);
+}
+
 static HRESULT interp_vcall(exec_ctx_t *ctx)
 {
     const unsigned arg_cnt = ctx->instr->arg1.uint;
@@ -814,18 +846,13 @@ static HRESULT assign_value(exec_ctx_t *ctx, VARIANT *dst, VARIANT *src, WORD fl
     return S_OK;
 }
 
-static HRESULT assign_ident(exec_ctx_t *ctx, BSTR name, WORD flags, DISPPARAMS *dp)
+static HRESULT assign_ref(exec_ctx_t *ctx, const ref_t *ref, BSTR name, WORD flags, DISPPARAMS *dp)
 {
-    ref_t ref;
     HRESULT hres;
 
-    hres = lookup_identifier(ctx, name, VBDISP_LET, &ref);
-    if(FAILED(hres))
-        return hres;
-
-    switch(ref.type) {
+    switch(ref->type) {
     case REF_VAR: {
-        VARIANT *v = ref.u.v;
+        VARIANT *v = ref->u.v;
 
         if(V_VT(v) == (VT_VARIANT|VT_BYREF))
             v = V_VARIANTREF(v);
@@ -872,7 +899,7 @@ static HRESULT assign_ident(exec_ctx_t *ctx, BSTR name, WORD flags, DISPPARAMS *
         break;
     }
     case REF_DISP:
-        hres = disp_propput(ctx->script, ref.u.d.disp, ref.u.d.id, flags, dp);
+        hres = disp_propput(ctx->script, ref->u.d.disp, ref->u.d.id, flags, dp);
         break;
     case REF_FUNC:
         FIXME("functions not implemented\n");
@@ -905,6 +932,18 @@ static HRESULT assign_ident(exec_ctx_t *ctx, BSTR name, WORD flags, DISPPARAMS *
     return hres;
 }
 
+static HRESULT assign_ident(exec_ctx_t *ctx, BSTR name, WORD flags, DISPPARAMS *dp)
+{
+    ref_t ref;
+    HRESULT hres;
+
+    hres = lookup_identifier(ctx, name, VBDISP_LET, &ref);
+    if(FAILED(hres))
+        return hres;
+
+    return assign_ref(ctx, &ref, name, flags, dp);
+}
+
 static HRESULT interp_assign_ident(exec_ctx_t *ctx)
 {
     const BSTR arg = ctx->instr->arg1.bstr;
@@ -945,6 +984,50 @@ static HRESULT interp_set_ident(exec_ctx_t *ctx)
     return S_OK;
 }
 
+static HRESULT interp_assign_local(exec_ctx_t *ctx)
+{
+    const int slot = ctx->instr->arg1.lng;
+    const unsigned arg_cnt = ctx->instr->arg2.uint;
+    DISPPARAMS dp;
+    ref_t ref;
+    HRESULT hres;
+
+    TRACE("%d %u\n", slot, arg_cnt);
+
+    lookup_local(ctx, slot, &ref);
+    vbstack_to_dp(ctx, arg_cnt, TRUE, &dp);
+    hres = assign_ref(ctx, &ref, NULL, DISPATCH_PROPERTYPUT, &dp);
+    if(FAILED(hres))
+        return hres;
+
+    stack_popn(ctx, arg_cnt+1);
+    return S_OK;
+}
+
+static HRESULT interp_set_local(exec_ctx_t *ctx)
+{
+    const int slot = ctx->instr->arg1.lng;
+    const unsigned arg_cnt = ctx->instr->arg2.uint;
+    DISPPARAMS dp;
+    ref_t ref;
+    HRESULT hres;
+
+    TRACE("%d %u\n", slot, arg_cnt);
+
+    hres = stack_assume_disp(ctx, arg_cnt, NULL);
+    if(FAILED(hres))
+        return hres;
+
+    lookup_local(ctx, slot, &ref);
+    vbstack_to_dp(ctx, arg_cnt, TRUE, &dp);
+    hres = assign_ref(ctx, &ref, NULL, DISPATCH_PROPERTYPUTREF, &dp);
+    if(FAILED(hres))
+        return hres;
+
+    stack_popn(ctx, arg_cnt + 1);
+    return S_OK;
+}
+
 static HRESULT interp_assign_member(exec_ctx_t *ctx)
 {
     BSTR identifier = ctx->instr->arg1.bstr;
@@ -1291,16 +1374,12 @@ static HRESULT interp_redim(exec_ctx_t *ctx)
     return S_OK;
 }
 
-static HRESULT interp_step(exec_ctx_t *ctx)
+static HRESULT do_step(exec_ctx_t *ctx, VARIANT *v)
 {
-    const BSTR ident = ctx->instr->arg2.bstr;
     BOOL gteq_zero;
     VARIANT zero;
-    ref_t ref;
     HRESULT hres;
 
-    TRACE("%s\n", debugstr_w(ident));
-
     V_VT(&zero) = VT_I2;
     V_I2(&zero) = 0;
     hres = VarCmp(stack_top(ctx, 0), &zero, ctx->script->lcid, 0);
@@ -1309,16 +1388,7 @@ static HRESULT interp_step(exec_ctx_t *ctx)
 
     gteq_zero = hres == VARCMP_GT || hres == VARCMP_EQ;
 
-    hres = lookup_identifier(ctx, ident, VBDISP_ANY, &ref);
-    if(FAILED(hres))
-        return hres;
-
-    if(ref.type != REF_VAR) {
-        FIXME("%s is not REF_VAR\n", debugstr_w(ident));
-        return E_FAIL;
-    }
-
-    hres = VarCmp(ref.u.v, stack_top(ctx, 1), ctx->script->lcid, 0);
+    hres = VarCmp(v, stack_top(ctx, 1), ctx->script->lcid, 0);
     if(FAILED(hres))
         return hres;
 
@@ -1331,6 +1401,37 @@ static HRESULT interp_step(exec_ctx_t *ctx)
     return S_OK;
 }
 
+static HRESULT interp_step(exec_ctx_t *ctx)
+{
+    const BSTR ident = ctx->instr->arg2.bstr;
+    ref_t ref;
+    HRESULT hres;
+
+    TRACE("%s\n", debugstr_w(ident));
+
+    hres = lookup_identifier(ctx, ident, VBDISP_ANY, &ref);
+    if(FAILED(hres))
+        return hres;
+
+    if(ref.type != REF_VAR) {
+        FIXME("%s is not REF_VAR\n", debugstr_w(ident));
+        return E_FAIL;
+    }
+
+    return do_step(ctx, ref.u.v);
+}
+
+static HRESULT interp_step_local(exec_ctx_t *ctx)
+{
+    const int slot = ctx->instr->arg2.lng;
+    ref_t ref;
+
+    TRACE("%d\n", slot);
+
+    lookup_local(ctx, slot, &ref);
+    return do_step(ctx, ref.u.v);
+}
+
 static HRESULT interp_newenum(exec_ctx_t *ctx)
 {
     variant_val_t v;
@@ -2221,10 +2322,23 @@ static HRESULT interp_neg(exec_ctx_t *ctx)
     return stack_push(ctx, &v);
 }
 
+static HRESULT do_incc(exec_ctx_t *ctx, VARIANT *var)
+{
+    VARIANT v;
+    HRESULT hres;
+
+    hres = VarAdd(stack_top(ctx, 0), var, &v);
+    if(FAILED(hres))
+        return hres;
+
+    VariantClear(var);
+    *var = v;
+    return S_OK;
+}
+
 static HRESULT interp_incc(exec_ctx_t *ctx)
 {
     const BSTR ident = ctx->instr->arg1.bstr;
-    VARIANT v;
     ref_t ref;
     HRESULT hres;
 
@@ -2239,13 +2353,18 @@ static HRESULT interp_incc(exec_ctx_t *ctx)
         return E_FAIL;
     }
 
-    hres = VarAdd(stack_top(ctx, 0), ref.u.v, &v);
-    if(FAILED(hres))
-        return hres;
+    return do_incc(ctx, ref.u.v);
+}
 
-    VariantClear(ref.u.v);
-    *ref.u.v = v;
-    return S_OK;
+static HRESULT interp_incc_local(exec_ctx_t *ctx)
+{
+    const int slot = ctx->instr->arg1.lng;
+    ref_t ref;
+
+    TRACE("%d\n", slot);
+
+    lookup_local(ctx, slot, &ref);
+    return do_incc(ctx, ref.u.v);
 }
 
 static HRESULT interp_catch(exec_ctx_t *ctx)
@@ -138,6 +138,71 @@ static inline FormatConverter *impl_from_IWICFormatConverter(IWICFormatConverter
     return CONTAINING_RECORD(iface, FormatConverter, IWICFormatConverter_iface);
 }
 
+/* v * 255 / alpha is computed as (v * unpremultiply_table[alpha]) >> 16,
+ * which gives exactly the same result for all 8-bit v and alpha. */
+static UINT unpremultiply_table[256];
+static INIT_ONCE init_tables_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL WINAPI init_tables(INIT_ONCE *once, void *param, void **context)
+{
+    UINT alpha;
+
+    unpremultiply_table[0] = 0;
+    for (alpha = 1; alpha < 256; alpha++)
+        unpremultiply_table[alpha] = (255 * 65536 + alpha - 1) / alpha;
+
+    return TRUE;
+}
+
+/* Exact x / 255 for 0 <= x <= 255 * 255. */
+static inline BYTE div_255(UINT x)
+{
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+static void premultiply_alpha(BYTE *bits, UINT width, UINT height, UINT stride)
+{
+    UINT x, y;
+
+    /* No special case for alpha == 255 so that the compiler can vectorize
+     * the inner loop, div_255(v * 255) == v anyway. */
+    for (y = 0; y < height; y++)
+    {
+        BYTE *pixel = bits + stride * y;
+
+        for (x = 0; x < width; x++, pixel += 4)
+        {
+            UINT alpha = pixel[3];
+
+            pixel[0] = div_255(pixel[0] * alpha);
+            pixel[1] = div_255(pixel[1] * alpha);
+            pixel[2] = div_255(pixel[2] * alpha);
+        }
+    }
+}
+
+static void unpremultiply_alpha(BYTE *bits, UINT width, UINT height, UINT stride)
+{
+    UINT x, y;
+
+    for (y = 0; y < height; y++)
+    {
+        BYTE *pixel = bits + stride * y;
+
+        for (x = 0; x < width; x++, pixel += 4)
+        {
+            UINT alpha = pixel[3], scale;
+
+            if (alpha == 0 || alpha == 255) continue;
+
+            scale = unpremultiply_table[alpha];
+            pixel[0] = (pixel[0] * scale) >> 16;
+            pixel[1] = (pixel[1] * scale) >> 16;
+            pixel[2] = (pixel[2] * scale) >> 16;
+        }
+    }
+}
+
 static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRect *prc,
     UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer, enum pixelformat source_format)
 {
@@ -730,22 +795,11 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
         if (prc)
         {
             HRESULT res;
-            INT x, y;
 
             res = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
             if (FAILED(res)) return res;
 
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 0 && alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * 255 / alpha;
-                    }
-                }
+            unpremultiply_alpha(pbBuffer, prc->Width, prc->Height, cbStride);
         }
         return S_OK;
     case format_48bppRGB:
@@ -893,22 +947,10 @@ static HRESULT copypixels_to_32bppRGBA(struct FormatConverter *This, const WICRe
     case format_32bppPRGBA:
         if (prc)
         {
-            INT x, y;
-
             hr = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
             if (FAILED(hr)) return hr;
 
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 0 && alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * 255 / alpha;
-                    }
-                }
+            unpremultiply_alpha(pbBuffer, prc->Width, prc->Height, cbStride);
         }
         return S_OK;
 
@@ -966,21 +1008,7 @@ static HRESULT copypixels_to_32bppPBGRA(struct FormatConverter *This, const WICR
     default:
         hr = copypixels_to_32bppBGRA(This, prc, cbStride, cbBufferSize, pbBuffer, source_format);
         if (SUCCEEDED(hr) && prc)
-        {
-            INT x, y;
-
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * alpha / 255;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * alpha / 255;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * alpha / 255;
-                    }
-                }
-        }
+            premultiply_alpha(pbBuffer, prc->Width, prc->Height, cbStride);
         return hr;
     }
 }
@@ -999,21 +1027,7 @@ static HRESULT copypixels_to_32bppPRGBA(struct FormatConverter *This, const WICR
     default:
         hr = copypixels_to_32bppRGBA(This, prc, cbStride, cbBufferSize, pbBuffer, source_format);
         if (SUCCEEDED(hr) && prc)
-        {
-            INT x, y;
-
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * alpha / 255;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * alpha / 255;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * alpha / 255;
-                    }
-                }
-        }
+            premultiply_alpha(pbBuffer, prc->Width, prc->Height, cbStride);
         return hr;
     }
 }
@@ -1397,25 +1411,47 @@ static HRESULT copypixels_to_8bppGray(struct FormatConverter *This, const WICRec
     return hr;
 }
 
-static UINT rgb_to_palette_index(BYTE bgr[3], WICColor *colors, UINT count)
+/* Images converted to a palette usually contain long runs of the same few
+ * colors, so remember the result of the nearest color search. */
+#define PALETTE_CACHE_SIZE 4096
+
+struct palette_cache
+{
+    UINT count;
+    BYTE r[256], g[256], b[256];
+    DWORD key[PALETTE_CACHE_SIZE]; /* 0x01rrggbb, 0 if the entry is unused */
+    BYTE index[PALETTE_CACHE_SIZE];
+};
+
+static void init_palette_cache(struct palette_cache *cache, const WICColor *colors, UINT count)
+{
+    UINT i;
+
+    cache->count = count;
+    for (i = 0; i < count; i++)
+    {
+        cache->r[i] = colors[i] >> 16;
+        cache->g[i] = colors[i] >> 8;
+        cache->b[i] = colors[i];
+    }
+    memset(cache->key, 0, sizeof(cache->key));
+}
+
+static UINT rgb_to_palette_index(const BYTE bgr[3], const struct palette_cache *cache)
 {
     UINT best_diff, best_index, i;
 
     best_diff = ~0;
     best_index = 0;
 
-    for (i = 0; i < count; i++)
+    for (i = 0; i < cache->count; i++)
     {
-        BYTE pal_r, pal_g, pal_b;
-        UINT diff_r, diff_g, diff_b, diff;
+        int diff_r, diff_g, diff_b;
+        UINT diff;
 
-        pal_r = colors[i] >> 16;
-        pal_g = colors[i] >> 8;
-        pal_b = colors[i];
-
-        diff_r = bgr[2] - pal_r;
-        diff_g = bgr[1] - pal_g;
-        diff_b = bgr[0] - pal_b;
+        diff_r = bgr[2] - cache->r[i];
+        diff_g = bgr[1] - cache->g[i];
+        diff_b = bgr[0] - cache->b[i];
 
         diff = diff_r * diff_r + diff_g * diff_g + diff_b * diff_b;
         if (diff == 0) return i;
@@ -1430,12 +1466,26 @@ static UINT rgb_to_palette_index(BYTE bgr[3], WICColor *colors, UINT count)
     return best_index;
 }
 
+static BYTE palette_cache_lookup(struct palette_cache *cache, const BYTE bgr[3])
+{
+    DWORD key = 0x01000000 | (bgr[2] << 16) | (bgr[1] << 8) | bgr[0];
+    UINT hash = ((key * 0x9e3779b1) >> 20) & (PALETTE_CACHE_SIZE - 1);
+
+    if (cache->key[hash] != key)
+    {
+        cache->key[hash] = key;
+        cache->index[hash] = rgb_to_palette_index(bgr, cache);
+    }
+    return cache->index[hash];
+}
+
 static HRESULT copypixels_to_8bppIndexed(struct FormatConverter *This, const WICRect *prc,
     UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer, enum pixelformat source_format)
 {
     HRESULT hr;
     BYTE *srcdata;
     WICColor colors[256];
+    struct palette_cache *cache;
     UINT srcstride, srcdatasize, count;
 
     if (source_format == format_8bppIndexed)
@@ -1460,6 +1510,13 @@ static HRESULT copypixels_to_8bppIndexed(struct FormatConverter *This, const WIC
     srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
     if (!srcdata) return E_OUTOFMEMORY;
 
+    if (!(cache = HeapAlloc(GetProcessHeap(), 0, sizeof(*cache))))
+    {
+        HeapFree(GetProcessHeap(), 0, srcdata);
+        return E_OUTOFMEMORY;
+    }
+    init_palette_cache(cache, colors, count);
+
     hr = copypixels_to_24bppBGR(This, prc, srcstride, srcdatasize, srcdata, source_format);
     if (SUCCEEDED(hr))
     {
@@ -1472,7 +1529,7 @@ static HRESULT copypixels_to_8bppIndexed(struct FormatConverter *This, const WIC
 
             for (x = 0; x < prc->Width; x++)
             {
-                dst[x] = rgb_to_palette_index(bgr, colors, count);
+                dst[x] = palette_cache_lookup(cache, bgr);
                 bgr += 3;
             }
             src += srcstride;
@@ -1480,6 +1537,7 @@ static HRESULT copypixels_to_8bppIndexed(struct FormatConverter *This, const WIC
         }
     }
 
+    HeapFree(GetProcessHeap(), 0, cache);
     HeapFree(GetProcessHeap(), 0, srcdata);
     return hr;
 }
@@ -1831,6 +1889,8 @@ HRESULT FormatConverter_CreateInstance(REFIID iid, void** ppv)
 
     *ppv = NULL;
 
+    InitOnceExecuteOnce(&init_tables_once, init_tables, NULL, NULL);
+
     This = HeapAlloc(GetProcessHeap(), 0, sizeof(FormatConverter));
     if (!This) return E_OUTOFMEMORY;
 
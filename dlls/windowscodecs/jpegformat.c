@@ -68,6 +68,7 @@ static const WCHAR wszJpegYCrCbSubsampling[] = {'J','p','e','g','Y','C','r','C',
 static const WCHAR wszSuppressApp0[] = {'S','u','p','p','r','e','s','s','A','p','p','0',0};
 
 #define MAKE_FUNCPTR(f) static typeof(f) * p##f
+MAKE_FUNCPTR(jpeg_abort_decompress);
 MAKE_FUNCPTR(jpeg_CreateCompress);
 MAKE_FUNCPTR(jpeg_CreateDecompress);
 MAKE_FUNCPTR(jpeg_destroy_compress);
@@ -93,6 +94,7 @@ static void *load_libjpeg(void)
         return NULL; \
     }
 
+        LOAD_FUNCPTR(jpeg_abort_decompress);
         LOAD_FUNCPTR(jpeg_CreateCompress);
         LOAD_FUNCPTR(jpeg_CreateDecompress);
         LOAD_FUNCPTR(jpeg_destroy_compress);
@@ -151,15 +153,24 @@ typedef struct {
     BOOL initialized;
     BOOL cinfo_initialized;
     IStream *stream;
+    ULONGLONG stream_pos; /* where libjpeg expects the stream to be positioned */
     struct jpeg_decompress_struct cinfo;
     struct jpeg_error_mgr jerr;
     struct jpeg_source_mgr source_mgr;
     BYTE source_buffer[1024];
+    J_COLOR_SPACE out_color_space;
     UINT bpp, stride;
-    BYTE *image_data;
+    BYTE *image_data; /* row y is at image_data + stride * (y % cached_rows) */
+    UINT cached_rows;
+    BOOL restart;
     CRITICAL_SECTION lock;
 } JpegDecoder;
 
+/* Scanlines are decoded on demand in CopyPixels. Up to this many bytes of
+ * decoded rows are kept, which holds the whole image for all but very
+ * large images. Reading rows that are no longer cached restarts decoding. */
+#define JPEG_MAX_CACHE_SIZE (32 * 1024 * 1024)
+
 static inline JpegDecoder *impl_from_IWICBitmapDecoder(IWICBitmapDecoder *iface)
 {
     return CONTAINING_RECORD(iface, JpegDecoder, IWICBitmapDecoder_iface);
@@ -258,10 +269,16 @@ static void source_mgr_init_source(j_decompress_ptr cinfo)
 static jpeg_boolean source_mgr_fill_input_buffer(j_decompress_ptr cinfo)
 {
     JpegDecoder *This = decoder_from_decompress(cinfo);
+    LARGE_INTEGER seek;
     HRESULT hr;
     ULONG bytesread;
 
-    hr = IStream_Read(This->stream, This->source_buffer, 1024, &bytesread);
+    /* Scanlines are decoded lazily, the stream may have been used by someone
+     * else since our last read. */
+    seek.QuadPart = This->stream_pos;
+    hr = IStream_Seek(This->stream, seek, STREAM_SEEK_SET, NULL);
+    if (SUCCEEDED(hr))
+        hr = IStream_Read(This->stream, This->source_buffer, 1024, &bytesread);
 
     if (FAILED(hr) || bytesread == 0)
     {
@@ -269,6 +286,7 @@ static jpeg_boolean source_mgr_fill_input_buffer(j_decompress_ptr cinfo)
     }
     else
     {
+        This->stream_pos += bytesread;
         This->source_mgr.next_input_byte = This->source_buffer;
         This->source_mgr.bytes_in_buffer = bytesread;
         return TRUE;
@@ -278,12 +296,10 @@ static jpeg_boolean source_mgr_fill_input_buffer(j_decompress_ptr cinfo)
 static void source_mgr_skip_input_data(j_decompress_ptr cinfo, long num_bytes)
 {
     JpegDecoder *This = decoder_from_decompress(cinfo);
-    LARGE_INTEGER seek;
 
     if (num_bytes > This->source_mgr.bytes_in_buffer)
     {
-        seek.QuadPart = num_bytes - This->source_mgr.bytes_in_buffer;
-        IStream_Seek(This->stream, seek, STREAM_SEEK_CUR, NULL);
+        This->stream_pos += num_bytes - This->source_mgr.bytes_in_buffer;
         This->source_mgr.bytes_in_buffer = 0;
     }
     else if (num_bytes > 0)
@@ -304,7 +320,6 @@ static HRESULT WINAPI JpegDecoder_Initialize(IWICBitmapDecoder *iface, IStream *
     int ret;
     LARGE_INTEGER seek;
     jmp_buf jmpbuf;
-    UINT data_size, i;
 
     TRACE("(%p,%p,%u)\n", iface, pIStream, cacheOptions);
 
@@ -340,6 +355,7 @@ static HRESULT WINAPI JpegDecoder_Initialize(IWICBitmapDecoder *iface, IStream *
 
     seek.QuadPart = 0;
     IStream_Seek(This->stream, seek, STREAM_SEEK_SET, NULL);
+    This->stream_pos = 0;
 
     This->source_mgr.bytes_in_buffer = 0;
     This->source_mgr.init_source = source_mgr_init_source;
@@ -384,55 +400,22 @@ static HRESULT WINAPI JpegDecoder_Initialize(IWICBitmapDecoder *iface, IStream *
         return E_FAIL;
     }
 
+    This->out_color_space = This->cinfo.out_color_space;
     if (This->cinfo.out_color_space == JCS_GRAYSCALE) This->bpp = 8;
     else if (This->cinfo.out_color_space == JCS_CMYK) This->bpp = 32;
     else This->bpp = 24;
 
     This->stride = (This->bpp * This->cinfo.output_width + 7) / 8;
-    data_size = This->stride * This->cinfo.output_height;
+    This->cached_rows = min(This->cinfo.output_height,
+        max(JPEG_MAX_CACHE_SIZE / This->stride, 16));
 
-    This->image_data = heap_alloc(data_size);
+    This->image_data = heap_alloc(This->stride * This->cached_rows);
     if (!This->image_data)
     {
         LeaveCriticalSection(&This->lock);
         return E_OUTOFMEMORY;
     }
 
-    while (This->cinfo.output_scanline < This->cinfo.output_height)
-    {
-        UINT first_scanline = This->cinfo.output_scanline;
-        UINT max_rows;
-        JSAMPROW out_rows[4];
-        JDIMENSION ret;
-
-        max_rows = min(This->cinfo.output_height-first_scanline, 4);
-        for (i=0; i<max_rows; i++)
-            out_rows[i] = This->image_data + This->stride * (first_scanline+i);
-
-        ret = pjpeg_read_scanlines(&This->cinfo, out_rows, max_rows);
-        if (ret == 0)
-        {
-            ERR("read_scanlines failed\n");
-            LeaveCriticalSection(&This->lock);
-            return E_FAIL;
-        }
-    }
-
-    if (This->bpp == 24)
-    {
-        /* libjpeg gives us RGB data and we want BGR, so byteswap the data */
-        reverse_bgr8(3, This->image_data,
-            This->cinfo.output_width, This->cinfo.output_height,
-            This->stride);
-    }
-
-    if (This->cinfo.out_color_space == JCS_CMYK && This->cinfo.saw_Adobe_marker)
-    {
-        /* Adobe JPEG's have inverted CMYK data. */
-        for (i=0; i<data_size; i++)
-            This->image_data[i] ^= 0xff;
-    }
-
     This->initialized = TRUE;
 
     LeaveCriticalSection(&This->lock);
@@ -639,16 +622,130 @@ static HRESULT WINAPI JpegDecoder_Frame_CopyPalette(IWICBitmapFrameDecode *iface
     return WINCODEC_ERR_PALETTEUNAVAILABLE;
 }
 
+/* Must be called with the lock held and a jmp_buf set up. */
+static HRESULT JpegDecoder_Restart(JpegDecoder *This)
+{
+    TRACE("(%p)\n", This);
+
+    pjpeg_abort_decompress(&This->cinfo);
+
+    This->stream_pos = 0;
+    This->source_mgr.bytes_in_buffer = 0;
+
+    if (pjpeg_read_header(&This->cinfo, TRUE) != JPEG_HEADER_OK)
+        return E_FAIL;
+
+    This->cinfo.out_color_space = This->out_color_space;
+    if (!pjpeg_start_decompress(&This->cinfo))
+        return E_FAIL;
+
+    This->restart = FALSE;
+    return S_OK;
+}
+
+/* Must be called with the lock held and a jmp_buf set up. */
+static HRESULT JpegDecoder_GetRow(JpegDecoder *This, UINT y, const BYTE **row)
+{
+    HRESULT hr;
+    UINT i;
+
+    if (y >= This->cinfo.output_scanline || This->cinfo.output_scanline - y > This->cached_rows
+            || This->restart)
+    {
+        if (y < This->cinfo.output_scanline || This->restart)
+        {
+            if (FAILED(hr = JpegDecoder_Restart(This)))
+                return hr;
+        }
+
+        while (This->cinfo.output_scanline <= y)
+        {
+            BYTE *data = This->image_data + This->stride * (This->cinfo.output_scanline % This->cached_rows);
+
+            if (!pjpeg_read_scanlines(&This->cinfo, &data, 1))
+            {
+                ERR("read_scanlines failed\n");
+                return E_FAIL;
+            }
+
+            if (This->bpp == 24)
+            {
+                /* libjpeg gives us RGB data and we want BGR, so byteswap the data */
+                reverse_bgr8(3, data, This->cinfo.output_width, 1, This->stride);
+            }
+
+            if (This->cinfo.out_color_space == JCS_CMYK && This->cinfo.saw_Adobe_marker)
+            {
+                /* Adobe JPEG's have inverted CMYK data. */
+                for (i = 0; i < This->stride; i++)
+                    data[i] ^= 0xff;
+            }
+        }
+    }
+
+    *row = This->image_data + This->stride * (y % This->cached_rows);
+    return S_OK;
+}
+
 static HRESULT WINAPI JpegDecoder_Frame_CopyPixels(IWICBitmapFrameDecode *iface,
     const WICRect *prc, UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer)
 {
     JpegDecoder *This = impl_from_IWICBitmapFrameDecode(iface);
+    UINT bytesperrow, width, height;
+    const BYTE *row;
+    jmp_buf jmpbuf;
+    HRESULT hr = S_OK;
+    WICRect rect;
+    INT y;
 
     TRACE("(%p,%s,%u,%u,%p)\n", iface, debug_wic_rect(prc), cbStride, cbBufferSize, pbBuffer);
 
-    return copy_pixels(This->bpp, This->image_data,
-        This->cinfo.output_width, This->cinfo.output_height, This->stride,
-        prc, cbStride, cbBufferSize, pbBuffer);
+    width = This->cinfo.output_width;
+    height = This->cinfo.output_height;
+
+    if (!prc)
+    {
+        rect.X = 0;
+        rect.Y = 0;
+        rect.Width = width;
+        rect.Height = height;
+        prc = &rect;
+    }
+    else if (prc->X < 0 || prc->Y < 0 || prc->X + prc->Width > width || prc->Y + prc->Height > height)
+        return E_INVALIDARG;
+
+    bytesperrow = (This->bpp * prc->Width + 7) / 8;
+
+    if (cbStride < bytesperrow)
+        return E_INVALIDARG;
+
+    if ((cbStride * (prc->Height - 1)) + bytesperrow > cbBufferSize)
+        return E_INVALIDARG;
+
+    EnterCriticalSection(&This->lock);
+
+    This->cinfo.client_data = jmpbuf;
+
+    if (setjmp(jmpbuf))
+    {
+        This->restart = TRUE;
+        LeaveCriticalSection(&This->lock);
+        return E_FAIL;
+    }
+
+    for (y = 0; y < prc->Height; y++)
+    {
+        if (FAILED(hr = JpegDecoder_GetRow(This, prc->Y + y, &row)))
+        {
+            This->restart = TRUE;
+            break;
+        }
+        memcpy(pbBuffer + cbStride * y, row + This->bpp / 8 * prc->X, bytesperrow);
+    }
+
+    LeaveCriticalSection(&This->lock);
+
+    return hr;
 }
 
 static HRESULT WINAPI JpegDecoder_Frame_GetMetadataQueryReader(IWICBitmapFrameDecode *iface,
@@ -784,7 +881,10 @@ HRESULT JpegDecoder_CreateInstance(REFIID iid, void** ppv)
     This->initialized = FALSE;
     This->cinfo_initialized = FALSE;
     This->stream = NULL;
+    This->stream_pos = 0;
     This->image_data = NULL;
+    This->cached_rows = 0;
+    This->restart = FALSE;
     InitializeCriticalSection(&This->lock);
     This->lock.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": JpegDecoder.lock");
 
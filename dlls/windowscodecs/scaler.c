@@ -20,6 +20,7 @@
 #include "config.h"
 
 #include <stdarg.h>
+#include <math.h>
 
 #define COBJMACROS
 
@@ -29,10 +30,30 @@
 
 #include "wincodecs_private.h"
 
+#include "wine/heap.h"
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(wincodecs);
 
+enum filter_type
+{
+    FILTER_BOX,
+    FILTER_LINEAR,
+    FILTER_CUBIC,
+};
+
+/* Maximum number of horizontally filtered source rows cached between CopyPixels calls */
+#define MAX_CACHED_ROWS 16
+
+/* Contribution of source pixels to each destination pixel along one axis. */
+struct filter_weights
+{
+    UINT *start;    /* first contributing source pixel */
+    UINT *count;    /* number of contributing source pixels */
+    float *weights; /* max_count weights for each destination pixel */
+    UINT max_count;
+};
+
 typedef struct BitmapScaler {
     IWICBitmapScaler IWICBitmapScaler_iface;
     LONG ref;
@@ -44,6 +65,17 @@ typedef struct BitmapScaler {
     UINT bpp;
     void (*fn_get_required_source_rect)(struct BitmapScaler*,UINT,UINT,WICRect*);
     void (*fn_copy_scanline)(struct BitmapScaler*,UINT,UINT,UINT,BYTE**,UINT,UINT,BYTE*);
+    BOOL filtered;
+    BOOL straight_alpha; /* filter premultiplied colors, alpha is in the 4th channel */
+    struct filter_weights xweights, yweights;
+    /* Horizontally filtered source rows, kept between CopyPixels calls so
+     * that reading the image one scanline at a time reads each source row
+     * only once. Row y is stored in slot y % rows_count. */
+    BYTE *src_row;
+    float *rows;
+    INT *row_y;
+    UINT rows_x, rows_width, rows_count;
+    SIZE_T rows_size;
     CRITICAL_SECTION lock; /* must be held when initialized */
 } BitmapScaler;
 
@@ -57,6 +89,14 @@ static inline BitmapScaler *impl_from_IMILBitmapScaler(IMILBitmapScaler *iface)
     return CONTAINING_RECORD(iface, BitmapScaler, IMILBitmapScaler_iface);
 }
 
+static void free_filter_weights(struct filter_weights *weights)
+{
+    heap_free(weights->start);
+    heap_free(weights->count);
+    heap_free(weights->weights);
+    memset(weights, 0, sizeof(*weights));
+}
+
 static HRESULT WINAPI BitmapScaler_QueryInterface(IWICBitmapScaler *iface, REFIID iid,
     void **ppv)
 {
@@ -108,6 +148,11 @@ static ULONG WINAPI BitmapScaler_Release(IWICBitmapScaler *iface)
         This->lock.DebugInfo->Spare[0] = 0;
         DeleteCriticalSection(&This->lock);
         if (This->source) IWICBitmapSource_Release(This->source);
+        free_filter_weights(&This->xweights);
+        free_filter_weights(&This->yweights);
+        heap_free(This->src_row);
+        heap_free(This->rows);
+        heap_free(This->row_y);
         HeapFree(GetProcessHeap(), 0, This);
     }
 
@@ -205,6 +250,261 @@ static void NearestNeighbor_CopyScanline(BitmapScaler *This,
     }
 }
 
+/* Catmull-Rom spline */
+static float cubic_kernel(float x)
+{
+    x = fabsf(x);
+    if (x < 1.0f) return (1.5f * x - 2.5f) * x * x + 1.0f;
+    if (x < 2.0f) return ((-0.5f * x + 2.5f) * x - 4.0f) * x + 2.0f;
+    return 0.0f;
+}
+
+static float filter_weight(enum filter_type type, float distance, float scale)
+{
+    float lo, hi;
+
+    switch (type)
+    {
+    case FILTER_BOX:
+        /* Coverage of the source pixel by the destination pixel. */
+        lo = max(distance - 0.5f, -0.5f * scale);
+        hi = min(distance + 0.5f, 0.5f * scale);
+        return hi > lo ? hi - lo : 0.0f;
+    case FILTER_LINEAR:
+        distance = fabsf(distance / scale);
+        return distance < 1.0f ? 1.0f - distance : 0.0f;
+    case FILTER_CUBIC:
+        return cubic_kernel(distance / scale);
+    }
+
+    return 0.0f;
+}
+
+static HRESULT init_filter_weights(struct filter_weights *weights, enum filter_type type,
+    BOOL prefilter, UINT src_size, UINT dst_size)
+{
+    float ratio = (float)src_size / dst_size, scale, radius;
+    UINT i, j;
+
+    /* When shrinking, stretch the filter over the source so that every
+     * source pixel contributes to the result. */
+    scale = (prefilter && ratio > 1.0f) ? ratio : 1.0f;
+
+    switch (type)
+    {
+    case FILTER_BOX: radius = 0.5f * scale + 0.5f; break;
+    case FILTER_LINEAR: radius = scale; break;
+    default: radius = 2.0f * scale; break;
+    }
+
+    weights->max_count = min((UINT)ceilf(2.0f * radius) + 1, src_size);
+    if (dst_size > ~(SIZE_T)0 / sizeof(*weights->weights) / weights->max_count)
+        return WINCODEC_ERR_VALUEOVERFLOW;
+    weights->start = heap_alloc(dst_size * sizeof(*weights->start));
+    weights->count = heap_alloc(dst_size * sizeof(*weights->count));
+    weights->weights = heap_alloc((SIZE_T)dst_size * weights->max_count * sizeof(*weights->weights));
+    if (!weights->start || !weights->count || !weights->weights)
+    {
+        free_filter_weights(weights);
+        return E_OUTOFMEMORY;
+    }
+
+    for (i = 0; i < dst_size; i++)
+    {
+        float center = (i + 0.5f) * ratio - 0.5f, total = 0.0f;
+        float *w = weights->weights + i * weights->max_count;
+        INT lo = ceilf(center - radius), hi = floorf(center + radius);
+
+        if (lo < 0) lo = 0;
+        if (hi > (INT)src_size - 1) hi = src_size - 1;
+        if (hi - lo + 1 > (INT)weights->max_count) hi = lo + weights->max_count - 1;
+
+        weights->start[i] = lo;
+        weights->count[i] = hi >= lo ? hi - lo + 1 : 0;
+
+        for (j = 0; j < weights->count[i]; j++)
+            total += w[j] = filter_weight(type, lo + j - center, scale);
+
+        if (total == 0.0f)
+        {
+            /* fall back to the nearest source pixel */
+            weights->start[i] = min(i * src_size / dst_size, src_size - 1);
+            weights->count[i] = 1;
+            w[0] = 1.0f;
+            continue;
+        }
+
+        for (j = 0; j < weights->count[i]; j++)
+            w[j] /= total;
+    }
+
+    return S_OK;
+}
+
+static BOOL is_filterable_format(const WICPixelFormatGUID *format)
+{
+    static const WICPixelFormatGUID *formats[] =
+    {
+        &GUID_WICPixelFormat8bppGray,
+        &GUID_WICPixelFormat24bppBGR,
+        &GUID_WICPixelFormat24bppRGB,
+        &GUID_WICPixelFormat32bppBGR,
+        &GUID_WICPixelFormat32bppBGRA,
+        &GUID_WICPixelFormat32bppPBGRA,
+        &GUID_WICPixelFormat32bppRGB,
+        &GUID_WICPixelFormat32bppRGBA,
+        &GUID_WICPixelFormat32bppPRGBA,
+    };
+    UINT i;
+
+    for (i = 0; i < ARRAY_SIZE(formats); i++)
+        if (IsEqualGUID(format, formats[i])) return TRUE;
+
+    return FALSE;
+}
+
+/* Read source row y and filter it horizontally into the row cache. */
+static HRESULT Filtered_LoadRow(BitmapScaler *This, UINT y, float *row)
+{
+    UINT channels = This->bpp / 8, first, last, x, i, c;
+    const struct filter_weights *xw = &This->xweights;
+    WICRect rect;
+    HRESULT hr;
+
+    first = xw->start[This->rows_x];
+    last = first;
+    for (x = This->rows_x; x < This->rows_x + This->rows_width; x++)
+        last = max(last, xw->start[x] + xw->count[x]);
+
+    rect.X = first;
+    rect.Y = y;
+    rect.Width = last - first;
+    rect.Height = 1;
+
+    hr = IWICBitmapSource_CopyPixels(This->source, &rect, rect.Width * channels,
+        rect.Width * channels, This->src_row);
+    if (FAILED(hr)) return hr;
+
+    for (x = 0; x < This->rows_width; x++)
+    {
+        const float *w = xw->weights + (This->rows_x + x) * xw->max_count;
+        const BYTE *src = This->src_row + (xw->start[This->rows_x + x] - first) * channels;
+        float *dst = row + x * channels;
+
+        for (c = 0; c < channels; c++)
+            dst[c] = 0.0f;
+
+        if (This->straight_alpha)
+        {
+            /* Premultiply, so that colors of transparent pixels don't bleed into their neighbours. */
+            for (i = 0; i < xw->count[This->rows_x + x]; i++, src += channels)
+            {
+                float alpha = w[i] * src[3];
+
+                for (c = 0; c < 3; c++)
+                    dst[c] += alpha * src[c] / 255.0f;
+                dst[3] += alpha;
+            }
+            continue;
+        }
+
+        for (i = 0; i < xw->count[This->rows_x + x]; i++, src += channels)
+        {
+            for (c = 0; c < channels; c++)
+                dst[c] += w[i] * src[c];
+        }
+    }
+
+    return S_OK;
+}
+
+static HRESULT Filtered_CopyPixels(BitmapScaler *This, const WICRect *dest_rect,
+    UINT stride, BYTE *buffer)
+{
+    const struct filter_weights *yw = &This->yweights;
+    UINT channels = This->bpp / 8, row_size, x, y, i;
+    float *accum;
+    HRESULT hr = S_OK;
+
+    /* Rect is within destination size, and rows are at most MAX_CACHED_ROWS,
+       but make sure buffer sizes don't wrap around for huge images. */
+    if (dest_rect->Width > ~0u / channels || This->src_width > ~0u / channels ||
+        (SIZE_T)dest_rect->Width * channels > ~(SIZE_T)0 / sizeof(*accum) / This->rows_count)
+        return WINCODEC_ERR_VALUEOVERFLOW;
+    row_size = dest_rect->Width * channels;
+
+    if (This->rows_x != dest_rect->X || This->rows_width != dest_rect->Width)
+    {
+        SIZE_T size = (SIZE_T)row_size * This->rows_count;
+
+        if (size > This->rows_size)
+        {
+            float *rows = heap_realloc(This->rows, size * sizeof(*rows));
+            BYTE *src_row = heap_realloc(This->src_row, (SIZE_T)This->src_width * channels);
+
+            if (rows) This->rows = rows;
+            if (src_row) This->src_row = src_row;
+            if (!rows || !src_row) return E_OUTOFMEMORY;
+            This->rows_size = size;
+        }
+
+        This->rows_x = dest_rect->X;
+        This->rows_width = dest_rect->Width;
+        for (i = 0; i < This->rows_count; i++)
+            This->row_y[i] = -1;
+    }
+
+    if (!(accum = heap_alloc((SIZE_T)row_size * sizeof(*accum))))
+        return E_OUTOFMEMORY;
+
+    for (y = dest_rect->Y; y < dest_rect->Y + dest_rect->Height; y++)
+    {
+        const float *w = yw->weights + y * yw->max_count;
+        BYTE *dst = buffer + stride * (y - dest_rect->Y);
+
+        for (x = 0; x < row_size; x++)
+            accum[x] = 0.0f;
+
+        for (i = 0; i < yw->count[y]; i++)
+        {
+            UINT src_y = yw->start[y] + i, slot = src_y % This->rows_count;
+            const float *row = This->rows + (SIZE_T)slot * row_size;
+
+            if (This->row_y[slot] != (INT)src_y)
+            {
+                This->row_y[slot] = -1;
+                if (FAILED(hr = Filtered_LoadRow(This, src_y, This->rows + (SIZE_T)slot * row_size)))
+                    goto done;
+                This->row_y[slot] = src_y;
+            }
+
+            for (x = 0; x < row_size; x++)
+                accum[x] += w[i] * row[x];
+        }
+
+        if (This->straight_alpha)
+        {
+            for (x = 0; x < row_size; x += channels)
+            {
+                float alpha = accum[x + 3];
+
+                for (i = 0; i < 3; i++)
+                    accum[x + i] = alpha > 0.0f ? accum[x + i] * 255.0f / alpha : 0.0f;
+            }
+        }
+
+        for (x = 0; x < row_size; x++)
+        {
+            float value = accum[x] + 0.5f;
+            dst[x] = value <= 0.0f ? 0 : value >= 255.0f ? 255 : (BYTE)value;
+        }
+    }
+
+done:
+    heap_free(accum);
+    return hr;
+}
+
 static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
     const WICRect *prc, UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer)
 {
@@ -259,6 +559,12 @@ static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
         goto end;
     }
 
+    if (This->filtered)
+    {
+        hr = Filtered_CopyPixels(This, &dest_rect, cbStride, pbBuffer);
+        goto end;
+    }
+
     /* MSDN recommends calling CopyPixels once for each scanline from top to
      * bottom, and claims codecs optimize for this. Ideally, when called in this
      * way, we should avoid requesting a scanline from the source more than
@@ -314,6 +620,34 @@ end:
     return hr;
 }
 
+static HRESULT BitmapScaler_InitFilter(BitmapScaler *This, IWICBitmapSource *source,
+    enum filter_type type, BOOL prefilter)
+{
+    HRESULT hr;
+
+    hr = init_filter_weights(&This->xweights, type, prefilter, This->src_width, This->width);
+    if (SUCCEEDED(hr))
+        hr = init_filter_weights(&This->yweights, type, prefilter, This->src_height, This->height);
+    /* Each source row is accumulated right after it's loaded, so rows contributing to
+       the same destination row may share a slot, it only makes caching less effective. */
+    if (SUCCEEDED(hr))
+        This->rows_count = min(This->yweights.max_count, MAX_CACHED_ROWS);
+    if (SUCCEEDED(hr) && !(This->row_y = heap_alloc(This->rows_count * sizeof(*This->row_y))))
+        hr = E_OUTOFMEMORY;
+
+    if (FAILED(hr))
+    {
+        free_filter_weights(&This->xweights);
+        free_filter_weights(&This->yweights);
+        return hr;
+    }
+
+    This->filtered = TRUE;
+    IWICBitmapSource_AddRef(source);
+    This->source = source;
+    return S_OK;
+}
+
 static HRESULT WINAPI BitmapScaler_Initialize(IWICBitmapScaler *iface,
     IWICBitmapSource *pISource, UINT uiWidth, UINT uiHeight,
     WICBitmapInterpolationMode mode)
@@ -349,10 +683,34 @@ static HRESULT WINAPI BitmapScaler_Initialize(IWICBitmapScaler *iface,
         hr = get_pixelformat_bpp(&src_pixelformat, &This->bpp);
     }
 
+    if (SUCCEEDED(hr))
+        This->straight_alpha = IsEqualGUID(&src_pixelformat, &GUID_WICPixelFormat32bppBGRA) ||
+                               IsEqualGUID(&src_pixelformat, &GUID_WICPixelFormat32bppRGBA);
+
+    if (SUCCEEDED(hr) && mode != WICBitmapInterpolationModeNearestNeighbor
+            && !is_filterable_format(&src_pixelformat))
+    {
+        FIXME("mode %i not supported for format %s, using nearest neighbor\n",
+            mode, debugstr_guid(&src_pixelformat));
+        mode = WICBitmapInterpolationModeNearestNeighbor;
+    }
+
     if (SUCCEEDED(hr))
     {
         switch (mode)
         {
+        case WICBitmapInterpolationModeLinear:
+            hr = BitmapScaler_InitFilter(This, pISource, FILTER_LINEAR, FALSE);
+            break;
+        case WICBitmapInterpolationModeCubic:
+            hr = BitmapScaler_InitFilter(This, pISource, FILTER_CUBIC, FALSE);
+            break;
+        case WICBitmapInterpolationModeFant:
+            hr = BitmapScaler_InitFilter(This, pISource, FILTER_BOX, TRUE);
+            break;
+        case WICBitmapInterpolationModeHighQualityCubic:
+            hr = BitmapScaler_InitFilter(This, pISource, FILTER_CUBIC, TRUE);
+            break;
         default:
             FIXME("unsupported mode %i\n", mode);
             /* fall-through */
@@ -529,6 +887,15 @@ HRESULT BitmapScaler_Create(IWICBitmapScaler **scaler)
     This->src_height = 0;
     This->mode = 0;
     This->bpp = 0;
+    This->filtered = FALSE;
+    This->straight_alpha = FALSE;
+    memset(&This->xweights, 0, sizeof(This->xweights));
+    memset(&This->yweights, 0, sizeof(This->yweights));
+    This->src_row = NULL;
+    This->rows = NULL;
+    This->row_y = NULL;
+    This->rows_x = This->rows_width = This->rows_count = 0;
+    This->rows_size = 0;
     InitializeCriticalSection(&This->lock);
     This->lock.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": BitmapScaler.lock");
 
@@ -1312,6 +1312,156 @@ static void test_bitmap_scaler(void)
     IWICBitmap_Release(bitmap);
 }
 
+static void test_bitmap_scaler_modes(void)
+{
+    static const WICBitmapInterpolationMode modes[] =
+    {
+        WICBitmapInterpolationModeNearestNeighbor,
+        WICBitmapInterpolationModeLinear,
+        WICBitmapInterpolationModeCubic,
+        WICBitmapInterpolationModeFant,
+    };
+    static const struct
+    {
+        UINT width, height;
+    }
+    sizes[] =
+    {
+        {2, 1}, {3, 7}, {4, 3}, {16, 9},
+    };
+    BYTE src[8 * 6 * 4], buf[16 * 9 * 4 + 1];
+    IWICBitmapScaler *scaler;
+    IWICBitmap *bitmap;
+    UINT i, j, k, y;
+    HRESULT hr;
+
+    for (i = 0; i < sizeof(src); i += 4)
+    {
+        src[i] = 0x20;
+        src[i + 1] = 0x80;
+        src[i + 2] = 0xe0;
+        src[i + 3] = 0xff;
+    }
+
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 8, 6, &GUID_WICPixelFormat32bppBGRA,
+        8 * 4, sizeof(src), src, &bitmap);
+    ok(hr == S_OK, "Failed to create a bitmap, hr %#x.\n", hr);
+
+    for (i = 0; i < ARRAY_SIZE(modes); i++)
+    {
+        for (j = 0; j < ARRAY_SIZE(sizes); j++)
+        {
+            hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+            ok(hr == S_OK, "Failed to create bitmap scaler, hr %#x.\n", hr);
+
+            hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap,
+                sizes[j].width, sizes[j].height, modes[i]);
+            ok(hr == S_OK, "Mode %d: failed to initialize bitmap scaler, hr %#x.\n", modes[i], hr);
+
+            /* Scaling an image of a single color must not change that color,
+             * both for a single call and for a scanline at a time. */
+            memset(buf, 0, sizeof(buf));
+            hr = IWICBitmapScaler_CopyPixels(scaler, NULL, sizes[j].width * 4, sizeof(buf), buf);
+            ok(hr == S_OK, "Mode %d: failed to copy pixels, hr %#x.\n", modes[i], hr);
+            for (k = 0; k < sizes[j].width * sizes[j].height * 4; k++)
+                if (buf[k] != src[k % 4]) break;
+            ok(k == sizes[j].width * sizes[j].height * 4, "Mode %d, %ux%u: got %#x at %u.\n",
+                modes[i], sizes[j].width, sizes[j].height, buf[k], k);
+
+            memset(buf, 0, sizeof(buf));
+            for (y = 0; y < sizes[j].height; y++)
+            {
+                WICRect rect = {0, y, sizes[j].width, 1};
+
+                hr = IWICBitmapScaler_CopyPixels(scaler, &rect, sizes[j].width * 4,
+                    sizes[j].width * 4, buf + y * sizes[j].width * 4);
+                ok(hr == S_OK, "Mode %d: failed to copy pixels, hr %#x.\n", modes[i], hr);
+            }
+            for (k = 0; k < sizes[j].width * sizes[j].height * 4; k++)
+                if (buf[k] != src[k % 4]) break;
+            ok(k == sizes[j].width * sizes[j].height * 4, "Mode %d, %ux%u: got %#x at %u.\n",
+                modes[i], sizes[j].width, sizes[j].height, buf[k], k);
+
+            IWICBitmapScaler_Release(scaler);
+        }
+    }
+
+    IWICBitmap_Release(bitmap);
+}
+
+static void test_bitmap_scaler_high_quality_cubic(void)
+{
+    static const BYTE gray[8] = {0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff};
+    static const BYTE bgra[4 * 4] =
+    {
+        0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff, 0xff,
+        0x00, 0xff, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00,
+    };
+    IWICBitmapScaler *scaler;
+    IWICBitmap *bitmap;
+    BYTE buf[16];
+    HRESULT hr;
+    UINT i;
+
+    /* Shrinking a step edge keeps it monotonic and the far ends unchanged. */
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 8, 1, &GUID_WICPixelFormat8bppGray,
+        8, sizeof(gray), (BYTE *)gray, &bitmap);
+    ok(hr == S_OK, "Failed to create a bitmap, hr %#x.\n", hr);
+
+    hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+    ok(hr == S_OK, "Failed to create bitmap scaler, hr %#x.\n", hr);
+
+    hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap, 4, 1,
+        WICBitmapInterpolationModeHighQualityCubic);
+    if (hr == E_INVALIDARG)
+    {
+        win_skip("HighQualityCubic interpolation mode is not supported.\n");
+        IWICBitmapScaler_Release(scaler);
+        IWICBitmap_Release(bitmap);
+        return;
+    }
+    ok(hr == S_OK, "Failed to initialize bitmap scaler, hr %#x.\n", hr);
+
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 4, 4, buf);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#x.\n", hr);
+    ok(buf[0] <= 0x08, "Got unexpected value %#x.\n", buf[0]);
+    ok(buf[0] <= buf[1] && buf[1] < 0x80, "Got unexpected value %#x.\n", buf[1]);
+    ok(buf[2] > 0x80 && buf[2] <= buf[3], "Got unexpected value %#x.\n", buf[2]);
+    ok(buf[3] >= 0xf7, "Got unexpected value %#x.\n", buf[3]);
+    ok(buf[1] + buf[2] >= 0xfe && buf[1] + buf[2] <= 0x100, "Got asymmetric values %#x, %#x.\n",
+        buf[1], buf[2]);
+
+    IWICBitmapScaler_Release(scaler);
+    IWICBitmap_Release(bitmap);
+
+    /* Color of transparent pixels doesn't bleed into visible ones. */
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 4, 1, &GUID_WICPixelFormat32bppBGRA,
+        16, sizeof(bgra), (BYTE *)bgra, &bitmap);
+    ok(hr == S_OK, "Failed to create a bitmap, hr %#x.\n", hr);
+
+    hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+    ok(hr == S_OK, "Failed to create bitmap scaler, hr %#x.\n", hr);
+
+    hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap, 2, 1,
+        WICBitmapInterpolationModeHighQualityCubic);
+    ok(hr == S_OK, "Failed to initialize bitmap scaler, hr %#x.\n", hr);
+
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 8, 8, buf);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#x.\n", hr);
+    ok(buf[3] > buf[7], "Got unexpected alpha %#x, %#x.\n", buf[3], buf[7]);
+    for (i = 0; i < 2; i++)
+    {
+        if (!buf[i * 4 + 3]) continue;
+        ok(buf[i * 4] <= 0x02 && buf[i * 4 + 1] <= 0x02 && buf[i * 4 + 2] >= 0xfd,
+            "Pixel %u: got unexpected color %02x%02x%02x.\n", i, buf[i * 4 + 2], buf[i * 4 + 1], buf[i * 4]);
+    }
+
+    IWICBitmapScaler_Release(scaler);
+    IWICBitmap_Release(bitmap);
+}
+
 static LONG obj_refcount(void *obj)
 {
     IUnknown_AddRef((IUnknown *)obj);
@@ -1482,6 +1632,8 @@ START_TEST(bitmap)
     test_CreateBitmapFromHBITMAP();
     test_clipper();
     test_bitmap_scaler();
+    test_bitmap_scaler_modes();
+    test_bitmap_scaler_high_quality_cubic();
 
     IWICImagingFactory_Release(factory);
 
@@ -53,6 +53,7 @@ static void test_decode_adobe_cmyk(void)
     HGLOBAL hjpegdata;
     char *jpegdata;
     IStream *jpegstream;
+    LARGE_INTEGER seek;
     GUID guidresult;
     UINT count=0, width=0, height=0;
     BYTE imagedata[5 * 4] = {1};
@@ -121,6 +122,11 @@ static void test_decode_adobe_cmyk(void)
                     broken(IsEqualGUID(&guidresult, &GUID_WICPixelFormat24bppBGR)), /* xp/2003 */
                     "unexpected pixel format: %s\n", wine_dbgstr_guid(&guidresult));
 
+                /* The client may move the stream between Initialize and CopyPixels. */
+                seek.QuadPart = 0;
+                hr = IStream_Seek(jpegstream, seek, STREAM_SEEK_END, NULL);
+                ok(SUCCEEDED(hr), "Seek failed, hr=%x\n", hr);
+
                 /* We want to be sure our state tracking will not impact output
                  * data on subsequent calls */
                 for(i=2; i>0; --i)
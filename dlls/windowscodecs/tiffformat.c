@@ -256,10 +256,20 @@ typedef struct {
     TiffDecoder *parent;
     UINT index;
     tiff_decode_info decode_info;
-    INT cached_tile_x, cached_tile_y;
-    BYTE *cached_tile;
+    /* Decoded tiles, indexed by tile_x % tile_cache_count, so that reading
+     * a tiled image one scanline at a time decodes each tile only once. */
+    UINT tile_cache_count;
+    struct
+    {
+        INT x, y;
+    } *tile_cache_pos;
+    BYTE *tile_cache;
+    BYTE *cached_tile; /* the tile being decoded or copied */
 } TiffFrameDecode;
 
+/* Upper bound for the size of the tile cache of a frame. */
+#define TIFF_MAX_TILE_CACHE_SIZE (16 * 1024 * 1024)
+
 static const IWICBitmapFrameDecodeVtbl TiffFrameDecode_Vtbl;
 static const IWICMetadataBlockReaderVtbl TiffFrameDecode_BlockVtbl;
 
@@ -574,6 +584,12 @@ static HRESULT tiff_get_decode_info(TIFF *tiff, tiff_decode_info *decode_info)
             return E_FAIL;
         }
 
+        if (!decode_info->tile_width || !decode_info->tile_height)
+        {
+            WARN("invalid tile size %ux%u\n", decode_info->tile_width, decode_info->tile_height);
+            return E_FAIL;
+        }
+
         decode_info->tile_stride = ((decode_info->bpp * decode_info->tile_width + 7)/8);
         decode_info->tile_size = decode_info->tile_height * decode_info->tile_stride;
         decode_info->tiles_across = (decode_info->width + decode_info->tile_width - 1) / decode_info->tile_width;
@@ -849,10 +865,23 @@ static HRESULT WINAPI TiffDecoder_GetFrame(IWICBitmapDecoder *iface,
             IWICBitmapDecoder_AddRef(iface);
             result->index = index;
             result->decode_info = decode_info;
-            result->cached_tile_x = -1;
-            result->cached_tile = HeapAlloc(GetProcessHeap(), 0, decode_info.tile_size);
+            result->tile_cache_count = min(decode_info.tiles_across,
+                decode_info.tile_size ? max(TIFF_MAX_TILE_CACHE_SIZE / decode_info.tile_size, 1) : 1);
+            result->tile_cache_pos = HeapAlloc(GetProcessHeap(), 0,
+                result->tile_cache_count * sizeof(*result->tile_cache_pos));
+            result->tile_cache = HeapAlloc(GetProcessHeap(), 0,
+                result->tile_cache_count * decode_info.tile_size);
+            result->cached_tile = result->tile_cache;
+
+            if (result->tile_cache_pos)
+            {
+                UINT i;
 
-            if (result->cached_tile)
+                for (i = 0; i < result->tile_cache_count; i++)
+                    result->tile_cache_pos[i].x = -1;
+            }
+
+            if (result->tile_cache_pos && result->tile_cache)
                 *ppIBitmapFrame = &result->IWICBitmapFrameDecode_iface;
             else
             {
@@ -933,7 +962,8 @@ static ULONG WINAPI TiffFrameDecode_Release(IWICBitmapFrameDecode *iface)
     if (ref == 0)
     {
         IWICBitmapDecoder_Release(&This->parent->IWICBitmapDecoder_iface);
-        HeapFree(GetProcessHeap(), 0, This->cached_tile);
+        HeapFree(GetProcessHeap(), 0, This->tile_cache_pos);
+        HeapFree(GetProcessHeap(), 0, This->tile_cache);
         HeapFree(GetProcessHeap(), 0, This);
     }
 
@@ -1297,12 +1327,31 @@ static HRESULT TiffFrameDecode_ReadTile(TiffFrameDecode *This, UINT tile_x, UINT
             *byte = ~(*byte);
     }
 
-    This->cached_tile_x = tile_x;
-    This->cached_tile_y = tile_y;
-
     return S_OK;
 }
 
+static HRESULT TiffFrameDecode_SelectTile(TiffFrameDecode *This, UINT tile_x, UINT tile_y)
+{
+    UINT slot = tile_x % This->tile_cache_count;
+    HRESULT hr;
+
+    This->cached_tile = This->tile_cache + slot * This->decode_info.tile_size;
+
+    if (This->tile_cache_pos[slot].x == (INT)tile_x && This->tile_cache_pos[slot].y == (INT)tile_y)
+        return S_OK;
+
+    This->tile_cache_pos[slot].x = -1;
+
+    hr = TiffFrameDecode_ReadTile(This, tile_x, tile_y);
+    if (SUCCEEDED(hr))
+    {
+        This->tile_cache_pos[slot].x = tile_x;
+        This->tile_cache_pos[slot].y = tile_y;
+    }
+
+    return hr;
+}
+
 static HRESULT WINAPI TiffFrameDecode_CopyPixels(IWICBitmapFrameDecode *iface,
     const WICRect *prc, UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer)
 {
@@ -1351,10 +1400,7 @@ static HRESULT WINAPI TiffFrameDecode_CopyPixels(IWICBitmapFrameDecode *iface,
     {
         for (tile_y=min_tile_y; tile_y <= max_tile_y; tile_y++)
         {
-            if (tile_x != This->cached_tile_x || tile_y != This->cached_tile_y)
-            {
-                hr = TiffFrameDecode_ReadTile(This, tile_x, tile_y);
-            }
+            hr = TiffFrameDecode_SelectTile(This, tile_x, tile_y);
 
             if (SUCCEEDED(hr))
             {
@@ -21,6 +21,7 @@
 #include "wined3d_private.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3d);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
 WINE_DECLARE_DEBUG_CHANNEL(fps);
 
 #define WINED3D_INITIAL_CS_SIZE 4096
@@ -2888,6 +2889,7 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
     size_t queue_size = ARRAY_SIZE(queue->data);
     size_t header_size, packet_size, remaining;
     struct wined3d_cs_packet *packet;
+    BOOL stalled = FALSE;
 
     header_size = FIELD_OFFSET(struct wined3d_cs_packet, data[0]);
     packet_size = FIELD_OFFSET(struct wined3d_cs_packet, data[size]);
@@ -2938,6 +2940,12 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
 
         TRACE("Waiting for free space. Head %u, tail %u, packet size %lu.\n",
                 head, tail, (unsigned long)packet_size);
+        if (!stalled)
+        {
+            InterlockedIncrement(&cs->producer_stalls);
+            stalled = TRUE;
+        }
+        wined3d_pause();
     }
 
     packet = (struct wined3d_cs_packet *)&queue->data[queue->head];
@@ -2958,6 +2966,8 @@ static void wined3d_cs_mt_finish(struct wined3d_cs *cs, enum wined3d_cs_queue_id
     if (cs->thread_id == GetCurrentThreadId())
         return wined3d_cs_st_finish(cs, queue_id);
 
+    if (cs->queue[queue_id].head != *(volatile LONG *)&cs->queue[queue_id].tail)
+        InterlockedIncrement(&cs->producer_stalls);
     while (cs->queue[queue_id].head != *(volatile LONG *)&cs->queue[queue_id].tail)
         wined3d_pause();
 }
@@ -2985,6 +2995,49 @@ static void poll_queries(struct wined3d_cs *cs)
     }
 }
 
+struct wined3d_cs_stats
+{
+    DWORD start_time;
+    unsigned int op_count[WINED3D_CS_OP_STOP];
+    unsigned int wait_count;
+    LONG max_queue_usage;
+};
+
+static void wined3d_cs_update_stats(struct wined3d_cs_stats *stats,
+        const struct wined3d_cs_queue *queue, enum wined3d_cs_op opcode)
+{
+    LONG usage;
+
+    usage = (*(volatile LONG *)&queue->head - queue->tail) & (WINED3D_CS_QUEUE_SIZE - 1);
+    stats->max_queue_usage = max(stats->max_queue_usage, usage);
+    ++stats->op_count[opcode];
+}
+
+static void wined3d_cs_report_stats(struct wined3d_cs *cs, struct wined3d_cs_stats *stats)
+{
+    DWORD time = GetTickCount();
+    double seconds;
+    unsigned int i;
+
+    /* every 1.5 seconds */
+    if (time - stats->start_time <= 1500)
+        return;
+
+    seconds = (time - stats->start_time) / 1000.0;
+    TRACE_(d3d_perf)("%p: %.2f draws/s, %.2f dispatches/s, %u waits, %d producer stalls, "
+            "max queue usage %d bytes.\n", cs, stats->op_count[WINED3D_CS_OP_DRAW] / seconds,
+            stats->op_count[WINED3D_CS_OP_DISPATCH] / seconds, stats->wait_count,
+            InterlockedExchange(&cs->producer_stalls, 0), stats->max_queue_usage);
+    for (i = 0; i < ARRAY_SIZE(stats->op_count); ++i)
+    {
+        if (stats->op_count[i])
+            TRACE_(d3d_perf)("    %s: %.2f/s.\n", debug_cs_op(i), stats->op_count[i] / seconds);
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->start_time = time;
+}
+
 static void wined3d_cs_wait_event(struct wined3d_cs *cs)
 {
     InterlockedExchange(&cs->waiting_for_event, TRUE);
@@ -3004,9 +3057,25 @@ static void wined3d_cs_wait_event(struct wined3d_cs *cs)
     WaitForSingleObject(cs->event, INFINITE);
 }
 
+/* Work arriving within the time WINED3D_CS_SPIN_COUNT iterations take would
+ * have been picked up by spinning, so spin longer next time. Only back off
+ * when the thread was idle for longer than that. */
+static unsigned int wined3d_cs_update_spin_limit(unsigned int spin_limit, unsigned int spin_count,
+        LONGLONG spin_time, LONGLONG wait_time)
+{
+    if (spin_count <= WINED3D_CS_SPIN_COUNT
+            && wait_time < spin_time * (WINED3D_CS_SPIN_COUNT / spin_count))
+        return min(spin_limit * 2, WINED3D_CS_SPIN_COUNT);
+
+    return max(spin_limit / 2, WINED3D_CS_SPIN_COUNT_MIN);
+}
+
 static DWORD WINAPI wined3d_cs_run(void *ctx)
 {
+    LARGE_INTEGER spin_start, wait_start, wait_end;
     struct wined3d_cs_packet *packet;
+    unsigned int spin_limit = WINED3D_CS_SPIN_COUNT;
+    struct wined3d_cs_stats stats = {0};
     struct wined3d_cs_queue *queue;
     unsigned int spin_count = 0;
     struct wined3d_cs *cs = ctx;
@@ -3023,6 +3092,7 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
 
     list_init(&cs->query_poll_list);
     cs->thread_id = GetCurrentThreadId();
+    stats.start_time = GetTickCount();
     for (;;)
     {
         if (++poll == WINED3D_CS_QUERY_POLL_INTERVAL)
@@ -3037,8 +3107,22 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
             queue = &cs->queue[WINED3D_CS_QUEUE_DEFAULT];
             if (wined3d_cs_queue_is_empty(cs, queue))
             {
-                if (++spin_count >= WINED3D_CS_SPIN_COUNT && list_empty(&cs->query_poll_list))
+                if (!spin_count)
+                    QueryPerformanceCounter(&spin_start);
+                if (++spin_count >= spin_limit && list_empty(&cs->query_poll_list))
+                {
+                    if (TRACE_ON(d3d_perf))
+                    {
+                        ++stats.wait_count;
+                        wined3d_cs_report_stats(cs, &stats);
+                    }
+                    QueryPerformanceCounter(&wait_start);
                     wined3d_cs_wait_event(cs);
+                    QueryPerformanceCounter(&wait_end);
+                    spin_limit = wined3d_cs_update_spin_limit(spin_limit, spin_count,
+                            wait_start.QuadPart - spin_start.QuadPart, wait_end.QuadPart - wait_start.QuadPart);
+                    spin_count = 0;
+                }
                 continue;
             }
         }
@@ -3058,6 +3142,12 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
                 break;
             }
 
+            if (TRACE_ON(d3d_perf))
+            {
+                wined3d_cs_update_stats(&stats, queue, opcode);
+                wined3d_cs_report_stats(cs, &stats);
+            }
+
             wined3d_cs_op_handlers[opcode](cs, packet->data);
             TRACE("%s executed.\n", debug_cs_op(opcode));
         }
@@ -1437,6 +1437,13 @@ static void wined3d_device_set_light(struct wined3d_device *device,
 
     TRACE("device %p, light_idx %u, light %p.\n", device, light_idx, light);
 
+    if ((object = wined3d_light_state_get_light(&device->state.light_state, light_idx))
+            && !memcmp(&object->OriginalParms, light, sizeof(*light)))
+    {
+        TRACE("Application is setting the old values over, nothing to do.\n");
+        return;
+    }
+
     if (FAILED(wined3d_light_state_set_light(&device->state.light_state, light_idx, light, &object)))
         return;
 
@@ -1548,6 +1555,12 @@ static void wined3d_device_set_light_enable(struct wined3d_device *device, UINT
         }
     }
 
+    if (enable ? light_info->glIndex != -1 : !light_info->enabled)
+    {
+        TRACE("Application is setting the old value over, nothing to do.\n");
+        return;
+    }
+
     wined3d_light_state_enable_light(&device->state.light_state, &device->adapter->d3d_info, light_info, enable);
     wined3d_cs_emit_set_light_enable(device->cs, light_idx, enable);
 }
@@ -1602,6 +1615,12 @@ static void wined3d_device_set_material(struct wined3d_device *device, const str
 {
     TRACE("device %p, material %p.\n", device, material);
 
+    if (!memcmp(&device->state.material, material, sizeof(*material)))
+    {
+        TRACE("Application is setting the old values over, nothing to do.\n");
+        return;
+    }
+
     device->state.material = *material;
     wined3d_cs_emit_set_material(device->cs, material);
 }
@@ -1664,6 +1683,13 @@ void CDECL wined3d_device_set_viewports(struct wined3d_device *device, unsigned
                 viewports[i].width, viewports[i].height, viewports[i].min_z, viewports[i].max_z);
     }
 
+    if (device->state.viewport_count == viewport_count
+            && !memcmp(device->state.viewports, viewports, viewport_count * sizeof(*viewports)))
+    {
+        TRACE("App is setting the old viewports over, nothing to do.\n");
+        return;
+    }
+
     if (viewport_count)
         memcpy(device->state.viewports, viewports, viewport_count * sizeof(*viewports));
     else
@@ -2063,6 +2089,12 @@ static void wined3d_device_set_vs_consts_b(struct wined3d_device *device,
     TRACE("device %p, start_idx %u, count %u, constants %p.\n",
             device, start_idx, count, constants);
 
+    if (!memcmp(&device->state.vs_consts_b[start_idx], constants, count * sizeof(*constants)))
+    {
+        TRACE("Application is setting the old values over, nothing to do.\n");
+        return;
+    }
+
     memcpy(&device->state.vs_consts_b[start_idx], constants, count * sizeof(*constants));
     if (TRACE_ON(d3d))
     {
@@ -2081,6 +2113,12 @@ static void wined3d_device_set_vs_consts_i(struct wined3d_device *device,
     TRACE("device %p, start_idx %u, count %u, constants %p.\n",
             device, start_idx, count, constants);
 
+    if (!memcmp(&device->state.vs_consts_i[start_idx], constants, count * sizeof(*constants)))
+    {
+        TRACE("Application is setting the old values over, nothing to do.\n");
+        return;
+    }
+
     memcpy(&device->state.vs_consts_i[start_idx], constants, count * sizeof(*constants));
     if (TRACE_ON(d3d))
     {
@@ -2099,6 +2137,12 @@ static void wined3d_device_set_vs_consts_f(struct wined3d_device *device,
     TRACE("device %p, start_idx %u, count %u, constants %p.\n",
             device, start_idx, count, constants);
 
+    if (!memcmp(&device->state.vs_consts_f[start_idx], constants, count * sizeof(*constants)))
+    {
+        TRACE("Application is setting the old values over, nothing to do.\n");
+        return;
+    }
+
     memcpy(&device->state.vs_consts_f[start_idx], constants, count * sizeof(*constants));
     if (TRACE_ON(d3d))
     {
@@ -2171,6 +2215,12 @@ static void wined3d_device_set_ps_consts_b(struct wined3d_device *device,
     TRACE("device %p, start_idx %u, count %u, constants %p.\n",
             device, start_idx, count, constants);
 
+    if (!memcmp(&device->state.ps_consts_b[start_idx], constants, count * sizeof(*constants)))
+    {
+        TRACE("Application is setting the old values over, nothing to do.\n");
+        return;
+    }
+
     memcpy(&device->state.ps_consts_b[start_idx], constants, count * sizeof(*constants));
     if (TRACE_ON(d3d))
     {
@@ -2189,6 +2239,12 @@ static void wined3d_device_set_ps_consts_i(struct wined3d_device *device,
     TRACE("device %p, start_idx %u, count %u, constants %p.\n",
             device, start_idx, count, constants);
 
+    if (!memcmp(&device->state.ps_consts_i[start_idx], constants, count * sizeof(*constants)))
+    {
+        TRACE("Application is setting the old values over, nothing to do.\n");
+        return;
+    }
+
     memcpy(&device->state.ps_consts_i[start_idx], constants, count * sizeof(*constants));
     if (TRACE_ON(d3d))
     {
@@ -2207,6 +2263,12 @@ static void wined3d_device_set_ps_consts_f(struct wined3d_device *device,
     TRACE("device %p, start_idx %u, count %u, constants %p.\n",
             device, start_idx, count, constants);
 
+    if (!memcmp(&device->state.ps_consts_f[start_idx], constants, count * sizeof(*constants)))
+    {
+        TRACE("Application is setting the old values over, nothing to do.\n");
+        return;
+    }
+
     memcpy(&device->state.ps_consts_f[start_idx], constants, count * sizeof(*constants));
     if (TRACE_ON(d3d))
     {
@@ -4825,20 +4887,19 @@ HRESULT CDECL wined3d_device_set_rendertarget_view(struct wined3d_device *device
      * primary stateblock. */
     if (!view_idx && set_viewport)
     {
-        struct wined3d_state *state = &device->state;
+        struct wined3d_viewport viewport;
+        RECT scissor_rect;
 
-        state->viewports[0].x = 0;
-        state->viewports[0].y = 0;
-        state->viewports[0].width = view->width;
-        state->viewports[0].height = view->height;
-        state->viewports[0].min_z = 0.0f;
-        state->viewports[0].max_z = 1.0f;
-        state->viewport_count = 1;
-        wined3d_cs_emit_set_viewports(device->cs, 1, state->viewports);
+        viewport.x = 0;
+        viewport.y = 0;
+        viewport.width = view->width;
+        viewport.height = view->height;
+        viewport.min_z = 0.0f;
+        viewport.max_z = 1.0f;
+        wined3d_device_set_viewports(device, 1, &viewport);
 
-        SetRect(&state->scissor_rects[0], 0, 0, view->width, view->height);
-        state->scissor_rect_count = 1;
-        wined3d_cs_emit_set_scissor_rects(device->cs, 1, state->scissor_rects);
+        SetRect(&scissor_rect, 0, 0, view->width, view->height);
+        wined3d_device_set_scissor_rects(device, 1, &scissor_rect);
     }
 
     prev = device->state.fb.render_targets[view_idx];
@@ -795,7 +795,7 @@ static GstFlowReturn got_data_sink(GstPad *pad, GstObject *parent, GstBuffer *bu
     HRESULT hr;
     BYTE *ptr = NULL;
     IMediaSample *sample;
-    GstMapInfo info;
+    gsize size;
 
     TRACE("%p %p\n", pad, buf);
 
@@ -817,19 +817,22 @@ static GstFlowReturn got_data_sink(GstPad *pad, GstObject *parent, GstBuffer *bu
         return GST_FLOW_FLUSHING;
     }
 
-    gst_buffer_map(buf, &info, GST_MAP_READ);
+    size = gst_buffer_get_size(buf);
 
-    hr = IMediaSample_SetActualDataLength(sample, info.size);
+    hr = IMediaSample_SetActualDataLength(sample, size);
     if(FAILED(hr)){
         WARN("SetActualDataLength failed: %08x\n", hr);
+        gst_buffer_unref(buf);
+        IMediaSample_Release(sample);
         return GST_FLOW_FLUSHING;
     }
 
     IMediaSample_GetPointer(sample, &ptr);
 
-    memcpy(ptr, info.data, info.size);
-
-    gst_buffer_unmap(buf, &info);
+    /* Copy each memory block straight into the sample. Mapping the whole
+     * buffer would first merge buffers consisting of several blocks into a
+     * temporary allocation. */
+    gst_buffer_extract(buf, 0, ptr, size);
 
     if (GST_BUFFER_PTS_IS_VALID(buf)) {
         REFERENCE_TIME rtStart = gst_segment_to_running_time(pin->segment, GST_FORMAT_TIME, buf->pts);
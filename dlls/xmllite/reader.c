@@ -285,6 +285,7 @@ typedef struct
     struct list attrs; /* attributes list for current node */
     struct attribute *attr; /* current attribute */
     UINT attr_count;
+    struct list attr_pool; /* released attribute records, reused by following nodes */
     struct list nsdef;
     struct list ns;
     struct list elements;
@@ -411,13 +412,34 @@ static void reader_clear_attrs(xmlreader *reader)
     {
         reader_free_strvalued(reader, &attr->localname);
         reader_free_strvalued(reader, &attr->value);
-        reader_free(reader, attr);
+        list_remove(&attr->entry);
+        list_add_head(&reader->attr_pool, &attr->entry);
     }
-    list_init(&reader->attrs);
     reader->attr_count = 0;
     reader->attr = NULL;
 }
 
+static void reader_free_attr_pool(xmlreader *reader)
+{
+    struct attribute *attr, *attr2;
+    LIST_FOR_EACH_ENTRY_SAFE(attr, attr2, &reader->attr_pool, struct attribute, entry)
+        reader_free(reader, attr);
+    list_init(&reader->attr_pool);
+}
+
+static struct attribute *reader_alloc_attr(xmlreader *reader)
+{
+    struct list *entry;
+
+    if ((entry = list_head(&reader->attr_pool)))
+    {
+        list_remove(entry);
+        return LIST_ENTRY(entry, struct attribute, entry);
+    }
+
+    return reader_alloc(reader, sizeof(struct attribute));
+}
+
 /* attribute data holds pointers to buffer data, so buffer shrink is not possible
    while we are on a node with attributes */
 static HRESULT reader_add_attr(xmlreader *reader, strval *prefix, strval *localname, strval *qname,
@@ -426,7 +448,7 @@ static HRESULT reader_add_attr(xmlreader *reader, strval *prefix, strval *localn
     struct attribute *attr;
     HRESULT hr;
 
-    attr = reader_alloc(reader, sizeof(*attr));
+    attr = reader_alloc_attr(reader);
     if (!attr) return E_OUTOFMEMORY;
 
     hr = reader_strvaldup(reader, localname, &attr->localname);
@@ -434,11 +456,11 @@ static HRESULT reader_add_attr(xmlreader *reader, strval *prefix, strval *localn
     {
         hr = reader_strvaldup(reader, value, &attr->value);
         if (hr != S_OK)
-            reader_free_strvalued(reader, &attr->value);
+            reader_free_strvalued(reader, &attr->localname);
     }
     if (hr != S_OK)
     {
-        reader_free(reader, attr);
+        list_add_head(&reader->attr_pool, &attr->entry);
         return hr;
     }
 
@@ -1162,6 +1184,17 @@ static void reader_skipn(xmlreader *reader, int n)
     }
 }
 
+/* moves cursor over n WCHARs starting at ptr, caller guarantees they are all in the buffer */
+static void reader_skip_run(xmlreader *reader, const WCHAR *ptr, UINT n)
+{
+    encoded_buffer *buffer = &reader->input->buffer->utf16;
+    UINT i;
+
+    for (i = 0; i < n; i++)
+        reader_update_position(reader, ptr[i]);
+    buffer->cur += n;
+}
+
 static inline BOOL is_wchar_space(WCHAR ch)
 {
     return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
@@ -1171,11 +1204,13 @@ static inline BOOL is_wchar_space(WCHAR ch)
 static int reader_skipspaces(xmlreader *reader)
 {
     const WCHAR *ptr = reader_get_ptr(reader);
-    UINT start = reader_get_cur(reader);
+    UINT start = reader_get_cur(reader), len;
 
     while (is_wchar_space(*ptr))
     {
-        reader_skipn(reader, 1);
+        for (len = 1; is_wchar_space(ptr[len]); len++)
+            ;
+        reader_skip_run(reader, ptr, len);
         ptr = reader_get_ptr(reader);
     }
 
@@ -1470,10 +1505,19 @@ static HRESULT reader_parse_comment(xmlreader *reader)
                 else
                     return WC_E_COMMENT;
             }
+
+            reader_skipn(reader, 1);
+            ptr++;
         }
+        else
+        {
+            UINT len;
 
-        reader_skipn(reader, 1);
-        ptr++;
+            for (len = 1; ptr[len] && ptr[len] != '-'; len++)
+                ;
+            reader_skip_run(reader, ptr, len);
+            ptr += len;
+        }
     }
 
     return S_OK;
@@ -1584,7 +1628,11 @@ static HRESULT reader_parse_name(xmlreader *reader, strval *name)
 
     while (is_namechar(*ptr))
     {
-        reader_skipn(reader, 1);
+        UINT len;
+
+        for (len = 1; is_namechar(ptr[len]); len++)
+            ;
+        reader_skip_run(reader, ptr, len);
         ptr = reader_get_ptr(reader);
     }
 
@@ -1944,7 +1992,11 @@ static HRESULT reader_parse_local(xmlreader *reader, strval *local, BOOL check_f
 
     while (is_ncnamechar(*ptr))
     {
-        reader_skipn(reader, 1);
+        UINT len;
+
+        for (len = 1; is_ncnamechar(ptr[len]); len++)
+            ;
+        reader_skip_run(reader, ptr, len);
         ptr = reader_get_ptr(reader);
     }
 
@@ -2215,9 +2267,15 @@ static HRESULT reader_parse_attvalue(xmlreader *reader, strval *value)
         }
         else
         {
+            UINT len = 0;
+
             /* replace all whitespace chars with ' ' */
-            if (is_wchar_space(*ptr)) *ptr = ' ';
-            reader_skipn(reader, 1);
+            do
+            {
+                if (is_wchar_space(ptr[len])) ptr[len] = ' ';
+                len++;
+            } while (ptr[len] && ptr[len] != quote && ptr[len] != '<' && ptr[len] != '&');
+            reader_skip_run(reader, ptr, len);
         }
         ptr = reader_get_ptr(reader);
     }
@@ -2473,7 +2531,7 @@ static HRESULT reader_parse_chardata(xmlreader *reader)
     position = reader->position;
     while (*ptr)
     {
-        static const WCHAR ampW[] = {'&',0};
+        UINT len;
 
         /* CDATA closing sequence ']]>' is not allowed */
         if (ptr[0] == ']' && ptr[1] == ']' && ptr[2] == '>')
@@ -2492,13 +2550,21 @@ static HRESULT reader_parse_chardata(xmlreader *reader)
             return S_OK;
         }
 
-        /* this covers a case when text has leading whitespace chars */
-        if (!is_wchar_space(*ptr)) reader->nodetype = XmlNodeType_Text;
-
-        if (!reader_cmp(reader, ampW))
+        if (ptr[0] == '&')
+        {
+            reader->nodetype = XmlNodeType_Text;
             reader_parse_reference(reader);
-        else
-            reader_skipn(reader, 1);
+            ptr = reader_get_ptr(reader);
+            continue;
+        }
+
+        /* skip whole run of plain characters, stopping at anything that may start markup */
+        for (len = 0; ptr[len] && ptr[len] != '<' && ptr[len] != '&' && (!len || ptr[len] != ']'); len++)
+        {
+            /* this covers a case when text has leading whitespace chars */
+            if (!is_wchar_space(ptr[len])) reader->nodetype = XmlNodeType_Text;
+        }
+        reader_skip_run(reader, ptr, len);
 
         ptr = reader_get_ptr(reader);
     }
@@ -2752,6 +2818,7 @@ static ULONG WINAPI xmlreader_Release(IXmlReader *iface)
     {
         IMalloc *imalloc = This->imalloc;
         reader_reset_parser(This);
+        reader_free_attr_pool(This);
         if (This->input) IUnknown_Release(&This->input->IXmlReaderInput_iface);
         if (This->resolver) IXmlResolver_Release(This->resolver);
         if (This->mlang) IUnknown_Release(This->mlang);
@@ -3673,6 +3740,7 @@ HRESULT WINAPI CreateXmlReader(REFIID riid, void **obj, IMalloc *imalloc)
     if (imalloc) IMalloc_AddRef(imalloc);
     reader->nodetype = XmlNodeType_None;
     list_init(&reader->attrs);
+    list_init(&reader->attr_pool);
     list_init(&reader->nsdef);
     list_init(&reader->ns);
     list_init(&reader->elements);
@@ -1730,6 +1730,8 @@ static struct test_entry text_tests[] =
     { "<a>text ]]> text</a>", L"", L"", WC_E_CDSECTEND },
     { "<a>\n \r\n \n\n text</a>", L"", L"\n \n \n\n text", S_OK, S_OK },
     { "<a>\r \r\r\n \n\n text</a>", L"", L"\n \n\n \n\n text", S_OK, S_OK },
+    { "<a>text ] ]] text]</a>", L"", L"text ] ]] text]", S_OK },
+    { "<a>  a&amp;b]c&lt;d</a>", L"", L"  a&b]c<d", S_OK },
     { NULL }
 };
 
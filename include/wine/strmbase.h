@@ -89,6 +89,14 @@ struct strmbase_sink
     IMemAllocator *preferred_allocator;
 
     const struct strmbase_sink_ops *pFuncsTable;
+
+    /* Receive() timing, collected when strmbase_perf tracing is enabled. */
+    struct
+    {
+        LONGLONG report_start, last_receive;
+        LONGLONG total_time, max_time, max_interval;
+        unsigned int count;
+    } stats;
 };
 
 typedef HRESULT (WINAPI *BaseInputPin_Receive)(struct strmbase_sink *This, IMediaSample *pSample);
@@ -63,6 +63,7 @@ struct pipe_end
     process_id_t         client_pid; /* process that created the client */
     process_id_t         server_pid; /* process that created the server */
     data_size_t          buffer_size;/* size of buffered data that doesn't block caller */
+    data_size_t          queued_size;/* size of unread data in message queue */
     struct list          message_queue;
     struct async_queue   read_q;     /* read queue */
     struct async_queue   write_q;    /* write queue */
@@ -370,6 +371,7 @@ static struct pipe_message *queue_message( struct pipe_end *pipe_end, struct ios
     message->async = NULL;
     message->read_pos = 0;
     list_add_tail( &pipe_end->message_queue, &message->entry );
+    pipe_end->queued_size += iosb->in_size;
     return message;
 }
 
@@ -386,8 +388,9 @@ static void wake_message( struct pipe_message *message, data_size_t result )
     release_object( async );
 }
 
-static void free_message( struct pipe_message *message )
+static void free_message( struct pipe_end *pipe_end, struct pipe_message *message )
 {
+    pipe_end->queued_size -= message->iosb->in_size - message->read_pos;
     list_remove( &message->entry );
     if (message->iosb) release_object( message->iosb );
     free( message );
@@ -408,7 +411,7 @@ static void pipe_end_disconnect( struct pipe_end *pipe_end, unsigned int status
     LIST_FOR_EACH_ENTRY_SAFE( message, next, &pipe_end->message_queue, struct pipe_message, entry )
     {
         async = message->async;
-        if (async || status == STATUS_PIPE_DISCONNECTED) free_message( message );
+        if (async || status == STATUS_PIPE_DISCONNECTED) free_message( pipe_end, message );
         if (!async) continue;
         async_terminate( async, status );
         release_object( async );
@@ -433,7 +436,7 @@ static void pipe_end_destroy( struct object *obj )
     {
         message = LIST_ENTRY( list_head(&pipe_end->message_queue), struct pipe_message, entry );
         assert( !message->async );
-        free_message( message );
+        free_message( pipe_end, message );
     }
 
     free_async_queue( &pipe_end->read_q );
@@ -760,7 +763,7 @@ static void message_queue_read( struct pipe_end *pipe_end, struct iosb *iosb )
         iosb->out_data = message->iosb->in_data;
         message->iosb->in_data = NULL;
         wake_message( message, message->iosb->in_size );
-        free_message( message );
+        free_message( pipe_end, message );
     }
     else
     {
@@ -781,10 +784,11 @@ static void message_queue_read( struct pipe_end *pipe_end, struct iosb *iosb )
             if (writing) memcpy( buf + write_pos, (const char *)message->iosb->in_data + message->read_pos, writing );
             write_pos += writing;
             message->read_pos += writing;
+            pipe_end->queued_size -= writing;
             if (message->read_pos == message->iosb->in_size)
             {
                 wake_message(message, message->iosb->in_size);
-                free_message(message);
+                free_message(pipe_end, message);
             }
         } while (write_pos < iosb->out_size);
     }
@@ -839,7 +843,7 @@ static void reselect_write_queue( struct pipe_end *pipe_end )
         {
             release_object( message->async );
             message->async = NULL;
-            free_message( message );
+            free_message( reader, message );
         }
         else
         {
@@ -851,7 +855,7 @@ static void reselect_write_queue( struct pipe_end *pipe_end )
             else if (message->async && (pipe_end->flags & NAMED_PIPE_NONBLOCKING_MODE))
             {
                 wake_message( message, message->read_pos );
-                free_message( message );
+                free_message( reader, message );
             }
         }
     }
@@ -895,6 +899,7 @@ static int pipe_end_write( struct fd *fd, struct async *async, file_pos_t pos )
 {
     struct pipe_end *pipe_end = get_fd_user( fd );
     struct pipe_message *message;
+    struct pipe_end *reader;
     struct iosb *iosb;
 
     switch (pipe_end->state)
@@ -914,14 +919,26 @@ static int pipe_end_write( struct fd *fd, struct async *async, file_pos_t pos )
 
     if (!pipe_end->pipe->message_mode && !get_req_data_size()) return 1;
 
+    reader = pipe_end->connection;
     iosb = async_get_iosb( async );
-    message = queue_message( pipe_end->connection, iosb );
+    message = queue_message( reader, iosb );
     release_object( iosb );
     if (!message) return 0;
 
     message->async = (struct async *)grab_object( async );
     queue_async( &pipe_end->write_q, async );
-    reselect_read_queue( pipe_end->connection, 1 );
+
+    if (reader->queued_size <= reader->buffer_size || !message->iosb->in_size)
+    {
+        /* Everything queued fits into the buffer, so this write completes right away and no other
+         * write can be waiting for space; skip rescanning the whole write queue. */
+        ignore_reselect = 1;
+        wake_message( message, message->iosb->in_size );
+        ignore_reselect = 0;
+        reselect_read_queue( reader, 0 );
+    }
+    else reselect_read_queue( reader, 1 );
+
     set_error( STATUS_PENDING );
     return 1;
 }
@@ -1187,6 +1204,7 @@ static void init_pipe_end( struct pipe_end *pipe_end, struct named_pipe *pipe,
     pipe_end->flags = pipe_flags;
     pipe_end->connection = NULL;
     pipe_end->buffer_size = buffer_size;
+    pipe_end->queued_size = 0;
     init_async_queue( &pipe_end->read_q );
     init_async_queue( &pipe_end->write_q );
     list_init( &pipe_end->message_queue );